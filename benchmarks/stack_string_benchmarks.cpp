@@ -0,0 +1,619 @@
+#include <benchmark/benchmark.h>
+#include <stack_string.hpp>
+#include <stack_string_column.hpp>
+#include <stack_string_flat_map.hpp>
+#include <stack_string_sort.hpp>
+#include <fixed_buf_allocator.hpp>
+
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using namespace stack_string;
+
+namespace {
+
+// Payload that fills a StackString<N> to its usable capacity (N - 1 chars)
+template <std::size_t N>
+const std::string& payload() {
+    static const std::string s(N > 0 ? N - 1 : 0, 'x');
+    return s;
+}
+
+// ---------------------------------------------------------------------------
+// append(const char*)
+// ---------------------------------------------------------------------------
+
+template <std::size_t N>
+void BM_StackString_AppendCStr(benchmark::State& state) {
+    const char* src = payload<N>().c_str();
+    for (auto _ : state) {
+        StackString<N> s;
+        s.append(src);
+        benchmark::DoNotOptimize(s.data());
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(payload<N>().size()));
+}
+
+template <std::size_t N>
+void BM_BufferString_AppendCStr(benchmark::State& state) {
+    const char* src = payload<N>().c_str();
+    for (auto _ : state) {
+        BufferString<N> s;  // Reserves its whole buffer, like StackString<N>
+        s.append(src);
+        benchmark::DoNotOptimize(s.data());
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(payload<N>().size()));
+}
+
+template <std::size_t N>
+void BM_StdString_AppendCStr(benchmark::State& state) {
+    const char* src = payload<N>().c_str();
+    for (auto _ : state) {
+        std::string s;
+        s.append(src);
+        benchmark::DoNotOptimize(s.data());
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(payload<N>().size()));
+}
+
+// ---------------------------------------------------------------------------
+// append of a string literal (length known at compile time)
+// ---------------------------------------------------------------------------
+
+template <std::size_t N>
+void BM_StackString_AppendLiteral(benchmark::State& state) {
+    for (auto _ : state) {
+        StackString<N> s;
+        s << "lit";
+        benchmark::DoNotOptimize(s.data());
+    }
+}
+
+// ---------------------------------------------------------------------------
+// append(std::string_view)
+// ---------------------------------------------------------------------------
+
+template <std::size_t N>
+void BM_StackString_AppendStringView(benchmark::State& state) {
+    std::string_view src = payload<N>();
+    for (auto _ : state) {
+        StackString<N> s;
+        s.append(src);
+        benchmark::DoNotOptimize(s.data());
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(src.size()));
+}
+
+template <std::size_t N>
+void BM_BufferString_AppendStringView(benchmark::State& state) {
+    std::string_view src = payload<N>();
+    for (auto _ : state) {
+        BufferString<N> s;  // Reserves its whole buffer, like StackString<N>
+        s.append(src);
+        benchmark::DoNotOptimize(s.data());
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(src.size()));
+}
+
+template <std::size_t N>
+void BM_StdString_AppendStringView(benchmark::State& state) {
+    std::string_view src = payload<N>();
+    for (auto _ : state) {
+        std::string s;
+        s.append(src);
+        benchmark::DoNotOptimize(s.data());
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(src.size()));
+}
+
+// ---------------------------------------------------------------------------
+// Integer append via std::to_chars (6 digits so it fits every size)
+// ---------------------------------------------------------------------------
+
+template <std::size_t N>
+void BM_StackString_AppendInt(benchmark::State& state) {
+    std::uint64_t value = 123456;
+    for (auto _ : state) {
+        StackString<N> s;
+        benchmark::DoNotOptimize(value);
+        s.append(value);
+        benchmark::DoNotOptimize(s.data());
+    }
+}
+
+template <std::size_t N>
+void BM_BufferString_AppendInt(benchmark::State& state) {
+    std::uint64_t value = 123456;
+    for (auto _ : state) {
+        BufferString<N> s;  // Reserves its whole buffer, like StackString<N>
+        benchmark::DoNotOptimize(value);
+        s.append(std::to_string(value));
+        benchmark::DoNotOptimize(s.data());
+    }
+}
+
+template <std::size_t N>
+void BM_StdString_AppendInt(benchmark::State& state) {
+    std::uint64_t value = 123456;
+    for (auto _ : state) {
+        std::string s;
+        benchmark::DoNotOptimize(value);
+        s.append(std::to_string(value));
+        benchmark::DoNotOptimize(s.data());
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Floating-point append: std::to_chars into the buffer vs snprintf + copy
+// ---------------------------------------------------------------------------
+
+template <std::size_t N>
+void BM_StackString_AppendDouble(benchmark::State& state) {
+    double value = 101.25;
+    for (auto _ : state) {
+        StackString<N> s;
+        benchmark::DoNotOptimize(value);
+        s.append(value, std::chars_format::fixed, 2);
+        benchmark::DoNotOptimize(s.data());
+    }
+}
+
+template <std::size_t N>
+void BM_StdString_AppendDouble(benchmark::State& state) {
+    double value = 101.25;
+    for (auto _ : state) {
+        std::string s;
+        benchmark::DoNotOptimize(value);
+        char tmp[32];
+        int len = std::snprintf(tmp, sizeof(tmp), "%.2f", value);
+        s.append(tmp, static_cast<std::size_t>(len));
+        benchmark::DoNotOptimize(s.data());
+    }
+}
+
+// ---------------------------------------------------------------------------
+// operator<< chains (typical log line)
+// ---------------------------------------------------------------------------
+
+template <std::size_t N>
+void BM_StackString_StreamChain(benchmark::State& state) {
+    int user = 1001;
+    int count = 5;
+    for (auto _ : state) {
+        StackString<N> s;
+        benchmark::DoNotOptimize(user);
+        s << "User " << user << " has " << count << " messages" << ';';
+        benchmark::DoNotOptimize(s.data());
+    }
+}
+
+// Composite key from parts: one operator+ expression vs. chained appends
+template <std::size_t N>
+void BM_StackString_ConcatKey(benchmark::State& state) {
+    StackString<16> user("alice");
+    StackString<8> region("eu");
+    int shard = 42;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(shard);
+        StackString<N> s(user + ':' + region + ':' + shard);
+        benchmark::DoNotOptimize(s.data());
+    }
+}
+
+template <std::size_t N>
+void BM_StackString_AppendKey(benchmark::State& state) {
+    StackString<16> user("alice");
+    StackString<8> region("eu");
+    int shard = 42;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(shard);
+        StackString<N> s;
+        s << user << ':' << region << ':' << shard;
+        benchmark::DoNotOptimize(s.data());
+    }
+}
+
+// HHMMSS.uuuuuu timestamp: fixed-width pair kernel vs. snprintf
+void BM_StackString_PaddedTimestamp(benchmark::State& state) {
+    unsigned h = 9, m = 30, sec = 5, us = 1234;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(us);
+        StackString<32> s;
+        s << pad<2>(h) << pad<2>(m) << pad<2>(sec) << '.' << pad<6>(us);
+        benchmark::DoNotOptimize(s.data());
+    }
+}
+
+void BM_Snprintf_PaddedTimestamp(benchmark::State& state) {
+    unsigned h = 9, m = 30, sec = 5, us = 1234;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(us);
+        char s[32];
+        std::snprintf(s, sizeof(s), "%02u%02u%02u.%06u", h, m, sec, us);
+        benchmark::DoNotOptimize(s);
+    }
+}
+
+void BM_StackString_AppendHex(benchmark::State& state) {
+    std::uint64_t id = 0x1234abcd5678ef90ULL;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(id);
+        StackString<32> s;
+        s << hex(id, 16);
+        benchmark::DoNotOptimize(s.data());
+    }
+}
+
+// 16-digit decimal field: SWAR fast path vs. std::from_chars
+void BM_StackString_ParseU64(benchmark::State& state) {
+    StackString<32> field("1234567890123456");
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(field.data());
+        auto r = field.parse<std::uint64_t>();
+        benchmark::DoNotOptimize(r);
+    }
+}
+
+void BM_FromChars_ParseU64(benchmark::State& state) {
+    StackString<32> field("1234567890123456");
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(field.data());
+        std::uint64_t value = 0;
+        auto r = std::from_chars(field.data(), field.data() + field.size(), value);
+        benchmark::DoNotOptimize(r);
+        benchmark::DoNotOptimize(value);
+    }
+}
+
+template <std::size_t N>
+void BM_StdString_StreamChain(benchmark::State& state) {
+    int user = 1001;
+    int count = 5;
+    for (auto _ : state) {
+        std::string s;
+        benchmark::DoNotOptimize(user);
+        s += "User ";
+        s += std::to_string(user);
+        s += " has ";
+        s += std::to_string(count);
+        s += " messages";
+        s += ';';
+        benchmark::DoNotOptimize(s.data());
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Variadic constructor
+// ---------------------------------------------------------------------------
+
+template <std::size_t N>
+void BM_StackString_VariadicCtor(benchmark::State& state) {
+    int id = 1001;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(id);
+        StackString<N> s("ID: ", id, ", Status: ", "Active");
+        benchmark::DoNotOptimize(s.data());
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Copy and move
+// ---------------------------------------------------------------------------
+
+template <std::size_t N>
+void BM_StackString_Copy(benchmark::State& state) {
+    StackString<N> src(std::string_view(payload<N>()).substr(0, payload<N>().size() / 2));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(src.data());
+        StackString<N> dst(src);
+        benchmark::DoNotOptimize(dst.data());
+    }
+}
+
+template <std::size_t N>
+void BM_StackString_Move(benchmark::State& state) {
+    StackString<N> src(std::string_view(payload<N>()).substr(0, payload<N>().size() / 2));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(src.data());
+        StackString<N> dst(std::move(src));
+        benchmark::DoNotOptimize(dst.data());
+        src = dst;
+    }
+}
+
+template <std::size_t N>
+void BM_StdString_Copy(benchmark::State& state) {
+    std::string src(payload<N>().substr(0, payload<N>().size() / 2));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(src.data());
+        std::string dst(src);
+        benchmark::DoNotOptimize(dst.data());
+    }
+}
+
+template <std::size_t N>
+void BM_StdString_Move(benchmark::State& state) {
+    std::string src(payload<N>().substr(0, payload<N>().size() / 2));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(src.data());
+        std::string dst(std::move(src));
+        benchmark::DoNotOptimize(dst.data());
+        src = dst;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Search: inline-buffer SIMD kernels vs std::string_view
+// ---------------------------------------------------------------------------
+
+template <std::size_t N>
+void BM_StackString_FindChar(benchmark::State& state) {
+    StackString<N> s(std::string_view(payload<N>()).substr(0, payload<N>().size() - 1));
+    s << '|';
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(s.data());
+        benchmark::DoNotOptimize(s.find('|'));
+    }
+}
+
+template <std::size_t N>
+void BM_StringView_FindChar(benchmark::State& state) {
+    StackString<N> s(std::string_view(payload<N>()).substr(0, payload<N>().size() - 1));
+    s << '|';
+    std::string_view sv = s;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(sv.data());
+        benchmark::DoNotOptimize(sv.find('|'));
+    }
+}
+
+template <std::size_t N>
+void BM_StackString_FindSubstr(benchmark::State& state) {
+    StackString<N> s(std::string_view(payload<N>()).substr(0, payload<N>().size() - 3));
+    s << "35=";
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(s.data());
+        benchmark::DoNotOptimize(s.find("35="));
+    }
+}
+
+template <std::size_t N>
+void BM_StringView_FindSubstr(benchmark::State& state) {
+    StackString<N> s(std::string_view(payload<N>()).substr(0, payload<N>().size() - 3));
+    s << "35=";
+    std::string_view sv = s;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(sv.data());
+        benchmark::DoNotOptimize(sv.find("35="));
+    }
+}
+
+template <std::size_t N>
+void BM_StackString_Hash(benchmark::State& state) {
+    StackString<N> s(std::string_view(payload<N>()));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(s.data());
+        benchmark::DoNotOptimize(stack_string::hash(s));
+    }
+}
+
+template <std::size_t N>
+void BM_StdHash_StringView(benchmark::State& state) {
+    StackString<N> s(std::string_view(payload<N>()));
+    std::string_view sv = s;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(sv.data());
+        benchmark::DoNotOptimize(std::hash<std::string_view>{}(sv));
+    }
+}
+
+// ---------------------------------------------------------------------------
+// to_lower/to_upper vs byte loops over std::string (header normalization).
+// Each iteration folds the same string both ways in place.
+// ---------------------------------------------------------------------------
+
+template <std::size_t N>
+void BM_StackString_FoldCase(benchmark::State& state) {
+    StackString<N> s(std::string_view(payload<N>()));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(s.to_upper().data());
+        benchmark::DoNotOptimize(s.to_lower().data());
+    }
+}
+
+template <std::size_t N>
+void BM_StdString_FoldCase(benchmark::State& state) {
+    std::string s = payload<N>();
+    for (auto _ : state) {
+        for (char& c : s) {
+            c = (c >= 'a' && c <= 'z') ? static_cast<char>(c - 32) : c;
+        }
+        benchmark::DoNotOptimize(s.data());
+        for (char& c : s) {
+            c = (c >= 'A' && c <= 'Z') ? static_cast<char>(c + 32) : c;
+        }
+        benchmark::DoNotOptimize(s.data());
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Symbol cache lookup: flat_map vs std::unordered_map<std::string, int>
+// ---------------------------------------------------------------------------
+
+constexpr int symbol_count = 1024;
+
+std::vector<StackString<16>> symbol_keys() {
+    std::vector<StackString<16>> keys;
+    for (int i = 0; i < symbol_count; ++i) {
+        keys.emplace_back("SYM.", i * 7919);
+    }
+    return keys;
+}
+
+void BM_FlatMap_Find(benchmark::State& state) {
+    const auto keys = symbol_keys();
+    flat_map<StackString<16>, int> m;
+    for (int i = 0; i < symbol_count; ++i) {
+        m.try_emplace(keys[i], i);
+    }
+    std::size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(m.find(keys[i++ % symbol_count])->second);
+    }
+}
+
+void BM_UnorderedMap_Find(benchmark::State& state) {
+    const auto keys = symbol_keys();
+    std::vector<std::string> strings(keys.begin(), keys.end());
+    std::unordered_map<std::string, int> m;
+    for (int i = 0; i < symbol_count; ++i) {
+        m.emplace(strings[i], i);
+    }
+    std::size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(m.find(strings[i++ % symbol_count])->second);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Equality scan: column<16> vs std::vector<StackString<16>>
+// ---------------------------------------------------------------------------
+
+constexpr int scan_rows = 65536;
+
+// Symbols of 5 to 11 characters; about one row in `one_in` (scattered
+// pseudo-randomly) is "SYM.1000000"
+std::vector<StackString<16>> scan_keys(std::int64_t one_in) {
+    std::vector<StackString<16>> keys;
+    std::uint32_t x = 12345;
+    for (int i = 0; i < scan_rows; ++i) {
+        x = x * 1664525u + 1013904223u;
+        keys.emplace_back("SYM.", (x >> 8) % one_in == 0 ? 1000000 : i * 7919 % 10000000);
+    }
+    return keys;
+}
+
+void BM_Column_SelectEqual(benchmark::State& state) {
+    column<16> c;
+    for (const auto& key : scan_keys(state.range(0))) {
+        c.push_back(key);
+    }
+    std::vector<std::uint32_t> out(c.size());
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(c.select_equal("SYM.1000000", out.data()));
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * scan_rows);
+}
+
+void BM_VectorStackString_SelectEqual(benchmark::State& state) {
+    const auto keys = scan_keys(state.range(0));
+    std::vector<std::uint32_t> out(keys.size());
+    for (auto _ : state) {
+        std::size_t n = 0;
+        for (std::size_t i = 0; i < keys.size(); ++i) {
+            if (keys[i] == "SYM.1000000") out[n++] = static_cast<std::uint32_t>(i);
+        }
+        benchmark::DoNotOptimize(n);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * scan_rows);
+}
+
+// ---------------------------------------------------------------------------
+// Sorting symbols: radix_sort vs std::sort
+// ---------------------------------------------------------------------------
+
+void BM_RadixSort_Symbols(benchmark::State& state) {
+    const auto keys = scan_keys(1000000);
+    std::vector<StackString<16>> work;
+    for (auto _ : state) {
+        state.PauseTiming();
+        work = keys;
+        state.ResumeTiming();
+        radix_sort(work.begin(), work.end());
+        benchmark::DoNotOptimize(work.data());
+    }
+    state.SetItemsProcessed(state.iterations() * scan_rows);
+}
+
+void BM_StdSort_Symbols(benchmark::State& state) {
+    const auto keys = scan_keys(1000000);
+    std::vector<StackString<16>> work;
+    for (auto _ : state) {
+        state.PauseTiming();
+        work = keys;
+        state.ResumeTiming();
+        std::sort(work.begin(), work.end());
+        benchmark::DoNotOptimize(work.data());
+    }
+    state.SetItemsProcessed(state.iterations() * scan_rows);
+}
+
+} // namespace
+
+#define STACK_STRING_BENCHMARK_SIZES(func) \
+    BENCHMARK_TEMPLATE(func, 8);           \
+    BENCHMARK_TEMPLATE(func, 32);          \
+    BENCHMARK_TEMPLATE(func, 128);         \
+    BENCHMARK_TEMPLATE(func, 1024)
+
+STACK_STRING_BENCHMARK_SIZES(BM_StackString_AppendCStr);
+STACK_STRING_BENCHMARK_SIZES(BM_BufferString_AppendCStr);
+STACK_STRING_BENCHMARK_SIZES(BM_StdString_AppendCStr);
+
+STACK_STRING_BENCHMARK_SIZES(BM_StackString_AppendLiteral);
+
+STACK_STRING_BENCHMARK_SIZES(BM_StackString_AppendStringView);
+STACK_STRING_BENCHMARK_SIZES(BM_BufferString_AppendStringView);
+STACK_STRING_BENCHMARK_SIZES(BM_StdString_AppendStringView);
+
+STACK_STRING_BENCHMARK_SIZES(BM_StackString_AppendInt);
+STACK_STRING_BENCHMARK_SIZES(BM_BufferString_AppendInt);
+STACK_STRING_BENCHMARK_SIZES(BM_StdString_AppendInt);
+
+STACK_STRING_BENCHMARK_SIZES(BM_StackString_AppendDouble);
+STACK_STRING_BENCHMARK_SIZES(BM_StdString_AppendDouble);
+
+STACK_STRING_BENCHMARK_SIZES(BM_StackString_StreamChain);
+STACK_STRING_BENCHMARK_SIZES(BM_StdString_StreamChain);
+STACK_STRING_BENCHMARK_SIZES(BM_StackString_ConcatKey);
+STACK_STRING_BENCHMARK_SIZES(BM_StackString_AppendKey);
+
+BENCHMARK(BM_StackString_PaddedTimestamp);
+BENCHMARK(BM_Snprintf_PaddedTimestamp);
+BENCHMARK(BM_StackString_AppendHex);
+BENCHMARK(BM_StackString_ParseU64);
+BENCHMARK(BM_FromChars_ParseU64);
+
+STACK_STRING_BENCHMARK_SIZES(BM_StackString_VariadicCtor);
+
+STACK_STRING_BENCHMARK_SIZES(BM_StackString_Copy);
+STACK_STRING_BENCHMARK_SIZES(BM_StackString_Move);
+STACK_STRING_BENCHMARK_SIZES(BM_StdString_Copy);
+STACK_STRING_BENCHMARK_SIZES(BM_StdString_Move);
+
+STACK_STRING_BENCHMARK_SIZES(BM_StackString_FindChar);
+STACK_STRING_BENCHMARK_SIZES(BM_StringView_FindChar);
+STACK_STRING_BENCHMARK_SIZES(BM_StackString_FindSubstr);
+STACK_STRING_BENCHMARK_SIZES(BM_StringView_FindSubstr);
+
+STACK_STRING_BENCHMARK_SIZES(BM_StackString_Hash);
+STACK_STRING_BENCHMARK_SIZES(BM_StdHash_StringView);
+
+STACK_STRING_BENCHMARK_SIZES(BM_StackString_FoldCase);
+STACK_STRING_BENCHMARK_SIZES(BM_StdString_FoldCase);
+
+BENCHMARK(BM_FlatMap_Find);
+BENCHMARK(BM_UnorderedMap_Find);
+BENCHMARK(BM_Column_SelectEqual)->Arg(97)->Arg(2);
+BENCHMARK(BM_VectorStackString_SelectEqual)->Arg(97)->Arg(2);
+BENCHMARK(BM_RadixSort_Symbols);
+BENCHMARK(BM_StdSort_Symbols);
@@ -17,6 +17,8 @@ int main() {
     using BufferString = std::basic_string<char, std::char_traits<char>, FixedBufAllocator<char>>;
     
     BufferString str(alloc);
+    // Regrowth would strand each old block in the buffer, so reserve once
+    str.reserve(sizeof(buffer) - 1);
     
     std::cout << "Initial capacity: " << sizeof(buffer) << " bytes" << std::endl;
     std::cout << std::endl;
@@ -17,12 +17,8 @@ int main() {
     std::cout << "  Size: " << stack_str.size() << " / 128" << std::endl;
     std::cout << std::endl;
     
-    // Create a BufferString
-    char buffer[256];
-    FixedBufAllocator<char> alloc(buffer, sizeof(buffer));
-    using BufferString = std::basic_string<char, std::char_traits<char>, FixedBufAllocator<char>>;
-    
-    BufferString buffer_str(alloc);
+    // Create a BufferString (a std::basic_string over its own 256-byte buffer)
+    BufferString<256> buffer_str;
     buffer_str = "BufferString: " + std::to_string(100) + " records";
     
     std::cout << "BufferString content: \"" << buffer_str << "\"" << std::endl;
@@ -33,7 +29,7 @@ int main() {
     StackString<64> stack_msg;
     stack_msg << "Message " << 1 << ": Hello";
     
-    BufferString converted_str(alloc);
+    BufferString<256> converted_str;
     converted_str = stack_msg.c_str();  // Uses implicit conversion to const char*
     
     std::cout << "Converted from StackString: \"" << converted_str << "\"" << std::endl;
@@ -89,9 +85,7 @@ int main() {
     std::cout << "StackString log: \"" << stack_log.c_str() << "\"" << std::endl;
     
     // BufferString: No heap allocation (if fits in buffer), std::string compatibility
-    char log_buffer[256];
-    FixedBufAllocator<char> log_alloc(log_buffer, sizeof(log_buffer));
-    BufferString buffer_log(log_alloc);
+    BufferString<256> buffer_log;
     
     for (int i = 0; i < 5; ++i) {
         buffer_log += "Item " + std::to_string(i) + "; ";
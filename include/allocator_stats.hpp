@@ -0,0 +1,144 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdio>
+
+// Define STACK_STRING_ALLOCATOR_STATS to record allocation statistics in
+// FixedBufAllocator and FixedBufArena; without it recording compiles away
+
+namespace stack_string {
+
+#if defined(STACK_STRING_ALLOCATOR_STATS)
+constexpr bool allocator_stats_enabled = true;
+#else
+constexpr bool allocator_stats_enabled = false;
+#endif
+
+/**
+ * Allocation statistics of one allocator (or, summed, of one tag)
+ */
+struct allocator_stats {
+    std::size_t bytes_requested = 0;  // Sum of requested block sizes
+    std::size_t allocations = 0;      // Number of allocate() calls
+    std::size_t peak_used = 0;        // High-water mark of the buffer, in bytes
+    std::size_t wasted_bytes = 0;     // Freed but not reclaimed (e.g. regrowth)
+    std::size_t overflows = 0;        // Requests the buffer could not satisfy
+};
+
+/**
+ * A named bucket in the global registry. Allocators constructed with a tag
+ * add their events to it; peak_used is the largest peak of any of them.
+ * Tags register themselves on construction and must have static storage
+ * duration (see STACK_STRING_ALLOCATOR_TAG).
+ */
+class allocator_stats_tag {
+public:
+    explicit allocator_stats_tag(const char* name, const char* file = nullptr, int line = 0) noexcept
+        : m_name(name), m_file(file), m_line(line) {
+        std::atomic<const allocator_stats_tag*>& head = list_head();
+        m_next = head.load(std::memory_order_relaxed);
+        while (!head.compare_exchange_weak(m_next, this, std::memory_order_release, std::memory_order_relaxed)) {
+        }
+    }
+
+    allocator_stats_tag(const allocator_stats_tag&) = delete;
+    allocator_stats_tag& operator=(const allocator_stats_tag&) = delete;
+
+    const char* name() const noexcept { return m_name; }
+    const char* file() const noexcept { return m_file; }
+    int line() const noexcept { return m_line; }
+
+    allocator_stats stats() const noexcept {
+        allocator_stats s;
+        s.bytes_requested = m_bytes_requested.load(std::memory_order_relaxed);
+        s.allocations = m_allocations.load(std::memory_order_relaxed);
+        s.peak_used = m_peak_used.load(std::memory_order_relaxed);
+        s.wasted_bytes = m_wasted_bytes.load(std::memory_order_relaxed);
+        s.overflows = m_overflows.load(std::memory_order_relaxed);
+        return s;
+    }
+
+    void record_allocation(std::size_t bytes, std::size_t used) noexcept {
+        m_bytes_requested.fetch_add(bytes, std::memory_order_relaxed);
+        m_allocations.fetch_add(1, std::memory_order_relaxed);
+        record_peak(used);
+    }
+
+    void record_peak(std::size_t used) noexcept {
+        std::size_t peak = m_peak_used.load(std::memory_order_relaxed);
+        while (used > peak &&
+               !m_peak_used.compare_exchange_weak(peak, used, std::memory_order_relaxed)) {
+        }
+    }
+
+    void record_waste(std::size_t bytes) noexcept {
+        m_wasted_bytes.fetch_add(bytes, std::memory_order_relaxed);
+    }
+
+    void record_overflow() noexcept {
+        m_overflows.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    const allocator_stats_tag* next() const noexcept {
+        return m_next;
+    }
+
+    // Most recently constructed tag; next() walks the rest
+    static const allocator_stats_tag* first() noexcept {
+        return list_head().load(std::memory_order_acquire);
+    }
+
+private:
+    // Tags are only ever added, but function-local tags (as made by
+    // STACK_STRING_ALLOCATOR_TAG) are first constructed on whichever
+    // thread reaches them, so two may register at once: a lock-free push
+    static std::atomic<const allocator_stats_tag*>& list_head() noexcept {
+        static std::atomic<const allocator_stats_tag*> head{nullptr};
+        return head;
+    }
+
+    const char* m_name;
+    const char* m_file;
+    int m_line;
+    const allocator_stats_tag* m_next = nullptr;
+    std::atomic<std::size_t> m_bytes_requested{0};
+    std::atomic<std::size_t> m_allocations{0};
+    std::atomic<std::size_t> m_peak_used{0};
+    std::atomic<std::size_t> m_wasted_bytes{0};
+    std::atomic<std::size_t> m_overflows{0};
+};
+
+/**
+ * A tag for the call site, named name and labelled with its file and line:
+ *   FixedBufAllocator<char> alloc(buf, sizeof(buf), STACK_STRING_ALLOCATOR_TAG("parser"));
+ */
+#define STACK_STRING_ALLOCATOR_TAG(name)                                         \
+    ([]() -> ::stack_string::allocator_stats_tag& {                              \
+        static ::stack_string::allocator_stats_tag tag(name, __FILE__, __LINE__); \
+        return tag;                                                              \
+    }())
+
+/**
+ * Call fn(tag) for every registered tag
+ */
+template <typename Fn>
+void for_each_allocator_tag(Fn&& fn) {
+    for (const allocator_stats_tag* tag = allocator_stats_tag::first(); tag; tag = tag->next()) {
+        fn(*tag);
+    }
+}
+
+/**
+ * Print one line per registered tag
+ */
+inline void dump_allocator_stats(std::FILE* out = stderr) {
+    for_each_allocator_tag([out](const allocator_stats_tag& tag) {
+        allocator_stats s = tag.stats();
+        std::fprintf(out, "%s (%s:%d): requested=%zu allocations=%zu peak=%zu wasted=%zu overflows=%zu\n",
+                     tag.name(), tag.file() ? tag.file() : "?", tag.line(),
+                     s.bytes_requested, s.allocations, s.peak_used, s.wasted_bytes, s.overflows);
+    });
+}
+
+} // namespace stack_string
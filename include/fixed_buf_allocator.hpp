@@ -1,26 +1,262 @@
 #pragma once
 
+#include "allocator_stats.hpp"
+
 #include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <new>
+#include <string>
+#include <string_view>
 #include <type_traits>
 
 namespace stack_string {
 
+namespace detail {
+
+/**
+ * Bump-allocation state over an external buffer, shared by FixedBufAllocator
+ * (which holds it by value) and FixedBufArena (which allocators point to).
+ * Allocation bumps m_used; the most recent block can be freed or resized in
+ * place, and mark()/rewind()/reset() release whole regions.
+ *
+ * With STACK_STRING_ALLOCATOR_STATS defined it also keeps allocator_stats
+ * and forwards each event to an optional tag; otherwise the record_*
+ * helpers are empty and the state is just the four counters below.
+ */
+class FixedBufState {
+public:
+    FixedBufState(void* buffer, std::size_t capacity, allocator_stats_tag* tag = nullptr) noexcept
+        : m_buffer(static_cast<char*>(buffer))
+        , m_capacity(capacity)
+        , m_used(0) {
+#if defined(STACK_STRING_ALLOCATOR_STATS)
+        m_tag = tag;
+#else
+        (void)tag;
+#endif
+    }
+
+    // Block of bytes at the next address that is a multiple of alignment (a
+    // power of two); nullptr, and one more overflow counted, if it won't fit
+    void* allocate(std::size_t bytes, std::size_t alignment) noexcept {
+        if (m_buffer) {
+            std::uintptr_t next = reinterpret_cast<std::uintptr_t>(m_buffer + m_used);
+            std::size_t padding = static_cast<std::size_t>(-next & (alignment - 1));
+            if (padding <= m_capacity - m_used && bytes <= m_capacity - m_used - padding) {
+                char* result = m_buffer + m_used + padding;
+                m_used += padding + bytes;
+                record_allocation(bytes);
+                return result;
+            }
+        }
+        ++m_overflows;
+        record_overflow();
+        return nullptr;
+    }
+
+    // True if p points into the buffer (std::less gives a total order even
+    // for pointers from other allocations)
+    bool owns(const void* p) const noexcept {
+        const char* c = static_cast<const char*>(p);
+        std::less<const char*> less;
+        return m_buffer && !less(c, m_buffer) && less(c, m_buffer + m_capacity);
+    }
+
+    // Only the most recent block is reclaimed; its alignment padding stays
+    // used, and any other block is wasted until reset() or rewind()
+    void deallocate(void* p, std::size_t bytes) noexcept {
+        if (is_last(p, bytes)) {
+            m_used = static_cast<std::size_t>(static_cast<char*>(p) - m_buffer);
+        } else {
+            record_waste(bytes);
+        }
+    }
+
+    bool expand(void* p, std::size_t old_bytes, std::size_t new_bytes) noexcept {
+        if (!is_last(p, old_bytes)) {
+            return false;
+        }
+        std::size_t start = static_cast<std::size_t>(static_cast<char*>(p) - m_buffer);
+        if (new_bytes > m_capacity - start) {
+            return false;
+        }
+        m_used = start + new_bytes;
+        record_peak();
+        return true;
+    }
+
+    std::size_t mark() const noexcept {
+        return m_used;
+    }
+
+    void rewind(std::size_t mark) noexcept {
+        if (mark < m_used) {
+            m_used = mark;
+        }
+    }
+
+    void reset() noexcept {
+        m_used = 0;
+    }
+
+    char* buffer() const noexcept {
+        return m_buffer;
+    }
+
+    std::size_t used() const noexcept {
+        return m_used;
+    }
+
+    std::size_t capacity() const noexcept {
+        return m_capacity;
+    }
+
+    std::size_t overflow_count() const noexcept {
+        return m_overflows;
+    }
+
+    // All zero unless STACK_STRING_ALLOCATOR_STATS is defined
+    allocator_stats stats() const noexcept {
+#if defined(STACK_STRING_ALLOCATOR_STATS)
+        allocator_stats s = m_stats;
+        s.overflows = m_overflows;
+        return s;
+#else
+        return allocator_stats();
+#endif
+    }
+
+private:
+    void record_allocation(std::size_t bytes) noexcept {
+#if defined(STACK_STRING_ALLOCATOR_STATS)
+        m_stats.bytes_requested += bytes;
+        ++m_stats.allocations;
+        if (m_used > m_stats.peak_used) m_stats.peak_used = m_used;
+        if (m_tag) m_tag->record_allocation(bytes, m_used);
+#else
+        (void)bytes;
+#endif
+    }
+
+    void record_peak() noexcept {
+#if defined(STACK_STRING_ALLOCATOR_STATS)
+        if (m_used > m_stats.peak_used) m_stats.peak_used = m_used;
+        if (m_tag) m_tag->record_peak(m_used);
+#endif
+    }
+
+    void record_waste(std::size_t bytes) noexcept {
+#if defined(STACK_STRING_ALLOCATOR_STATS)
+        m_stats.wasted_bytes += bytes;
+        if (m_tag) m_tag->record_waste(bytes);
+#else
+        (void)bytes;
+#endif
+    }
+
+    void record_overflow() noexcept {
+#if defined(STACK_STRING_ALLOCATOR_STATS)
+        if (m_tag) m_tag->record_overflow();
+#endif
+    }
+
+    // True if [p, p + bytes) is the block that ends at m_used
+    bool is_last(void* p, std::size_t bytes) const noexcept {
+        return p && m_buffer && bytes <= m_used &&
+               static_cast<char*>(p) + bytes == m_buffer + m_used;
+    }
+
+    char* m_buffer;
+    std::size_t m_capacity;
+    std::size_t m_used;
+    std::size_t m_overflows = 0;
+#if defined(STACK_STRING_ALLOCATOR_STATS)
+    allocator_stats m_stats;
+    allocator_stats_tag* m_tag = nullptr;
+#endif
+};
+
+} // namespace detail
+
+/*
+ * Overflow policies: what allocate() does when the buffer cannot satisfy a
+ * request. Each provides static allocate(bytes, alignment) and
+ * deallocate(p, bytes, alignment) for the blocks it hands out; allocators
+ * route a deallocation to the policy when the pointer lies outside the buffer.
+ */
+
+// Return nullptr (the default, consistent with the no-exception policy)
+struct NullOnOverflow {
+    static void* allocate(std::size_t, std::size_t) noexcept {
+        return nullptr;
+    }
+
+    static void deallocate(void*, std::size_t, std::size_t) noexcept {}
+};
+
+// Throw std::bad_alloc, as std::allocator does
+struct ThrowOnOverflow {
+    [[noreturn]] static void* allocate(std::size_t, std::size_t) {
+        throw std::bad_alloc();
+    }
+
+    static void deallocate(void*, std::size_t, std::size_t) noexcept {}
+};
+
+// Fall back to a default-constructible upstream allocator (the heap by
+// default), so the buffer can be sized for the common case. Over-aligned
+// requests, which the upstream's char allocation cannot honour, use the
+// aligned operator new instead.
+template <typename Upstream = std::allocator<char>>
+struct UpstreamOnOverflow {
+    using upstream_type = typename std::allocator_traits<Upstream>::template rebind_alloc<char>;
+
+    static void* allocate(std::size_t bytes, std::size_t alignment) {
+        if (alignment > alignof(std::max_align_t)) {
+            return ::operator new(bytes, std::align_val_t(alignment));
+        }
+        upstream_type upstream;
+        return std::allocator_traits<upstream_type>::allocate(upstream, bytes);
+    }
+
+    static void deallocate(void* p, std::size_t bytes, std::size_t alignment) noexcept {
+        if (alignment > alignof(std::max_align_t)) {
+            ::operator delete(p, std::align_val_t(alignment));
+            return;
+        }
+        upstream_type upstream;
+        std::allocator_traits<upstream_type>::deallocate(upstream, static_cast<char*>(p), bytes);
+    }
+};
+
 /**
  * A stateful allocator that uses an external fixed buffer for allocations.
  * Designed for a single std::basic_string instance per buffer.
- * 
+ *
  * This allocator can be used with std::basic_string to create stack-based strings
  * while maintaining compatibility with the standard library.
- * 
+ *
+ * Allocation is a bump of m_used, padded so each block is aligned for T
+ * (or a larger requested alignment). The most recent block can be freed or
+ * resized in place, and reset()/mark()/rewind() reuse the buffer as an arena.
+ * Only LIFO frees are reclaimed: std::basic_string regrows by allocating the
+ * new block before freeing the old one, so each regrowth strands the old
+ * capacity. Reserve the final size up front (as BufferString does).
+ *
+ * Each copy tracks usage on its own; to share one buffer between several
+ * containers use FixedBufArena and ArenaAllocator.
+ *
  * @tparam T The type to allocate
+ * @tparam Overflow What to do when the buffer is exhausted (NullOnOverflow,
+ *         ThrowOnOverflow or UpstreamOnOverflow<>)
  */
-template <typename T>
+template <typename T, typename Overflow = NullOnOverflow>
 class FixedBufAllocator {
 private:
-    char* m_buffer;
-    std::size_t m_capacity;
-    std::size_t m_used;
-    
+    detail::FixedBufState m_state;
+
 public:
     using value_type = T;
     using size_type = std::size_t;
@@ -28,76 +264,560 @@ public:
     using propagate_on_container_copy_assignment = std::true_type;
     using propagate_on_container_move_assignment = std::true_type;
     using propagate_on_container_swap = std::true_type;
-    
+
     /**
      * Construct allocator with external buffer
      * @param buffer Pointer to buffer
      * @param capacity Size of buffer in bytes
      */
     FixedBufAllocator(void* buffer, std::size_t capacity) noexcept
-        : m_buffer(static_cast<char*>(buffer))
-        , m_capacity(capacity)
-        , m_used(0) {}
-    
+        : m_state(buffer, capacity) {}
+
+    /**
+     * Construct allocator that also reports its statistics to tag (see
+     * allocator_stats.hpp); the tag is ignored unless
+     * STACK_STRING_ALLOCATOR_STATS is defined
+     */
+    FixedBufAllocator(void* buffer, std::size_t capacity, allocator_stats_tag& tag) noexcept
+        : m_state(buffer, capacity, &tag) {}
+
     /**
      * Copy constructor for rebinding
      */
     template <typename U>
-    FixedBufAllocator(const FixedBufAllocator<U>& other) noexcept
-        : m_buffer(other.m_buffer)
-        , m_capacity(other.m_capacity)
-        , m_used(other.m_used) {}
-    
+    FixedBufAllocator(const FixedBufAllocator<U, Overflow>& other) noexcept
+        : m_state(other.m_state) {}
+
     /**
-     * Allocate n objects of type T
-     * Uses buffer if space available, returns nullptr if exhausted
+     * Allocate n objects of type T, aligned for T
+     * Uses buffer if space available, otherwise counts an overflow and
+     * defers to the Overflow policy (nullptr by default)
      */
     T* allocate(std::size_t n) {
-        std::size_t bytes = n * sizeof(T);
-        
-        // Try to allocate from buffer
-        if (m_buffer && m_used + bytes <= m_capacity) {
-            T* result = reinterpret_cast<T*>(m_buffer + m_used);
-            m_used += bytes;
-            return result;
-        }
-        
-        // Buffer exhausted - return nullptr
-        return nullptr;
+        return allocate(n, alignof(T));
     }
-    
+
+    /**
+     * Allocate n objects of type T at a multiple of alignment, e.g. 64 for
+     * cache-line aligned blocks; alignment is a power of two and at least
+     * alignof(T). Free with the same alignment.
+     */
+    T* allocate(std::size_t n, std::size_t alignment) {
+        void* p = m_state.allocate(n * sizeof(T), alignment);
+        return static_cast<T*>(p ? p : Overflow::allocate(n * sizeof(T), alignment));
+    }
+
     /**
      * Deallocate memory
-     * Does nothing for monotonic allocator
+     * Only the most recent block is reclaimed; others stay used until
+     * reset() or rewind(). Blocks from the Overflow policy go back to it.
+     */
+    void deallocate(T* p, std::size_t n) noexcept {
+        deallocate(p, n, alignof(T));
+    }
+
+    void deallocate(T* p, std::size_t n, std::size_t alignment) noexcept {
+        if (m_state.owns(p)) {
+            m_state.deallocate(p, n * sizeof(T));
+        } else {
+            Overflow::deallocate(p, n * sizeof(T), alignment);
+        }
+    }
+
+    /**
+     * Resize the most recent block in place from old_n to new_n objects
+     * @return false (and nothing changes) if p is not the most recent block
+     *         or the buffer cannot hold new_n objects
+     */
+    bool expand(T* p, std::size_t old_n, std::size_t new_n) noexcept {
+        return m_state.expand(p, old_n * sizeof(T), new_n * sizeof(T));
+    }
+
+    /**
+     * Arena checkpoint: the current position in the buffer
+     */
+    std::size_t mark() const noexcept {
+        return m_state.mark();
+    }
+
+    /**
+     * Release everything allocated since mark was taken
+     */
+    void rewind(std::size_t mark) noexcept {
+        m_state.rewind(mark);
+    }
+
+    /**
+     * Release everything, so the buffer can be reused for the next request
+     */
+    void reset() noexcept {
+        m_state.reset();
+    }
+
+    std::size_t used() const noexcept {
+        return m_state.used();
+    }
+
+    std::size_t capacity() const noexcept {
+        return m_state.capacity();
+    }
+
+    /**
+     * Number of requests the buffer could not satisfy (each one went to the
+     * Overflow policy)
      */
-    void deallocate(T*, std::size_t) noexcept {
-        // Monotonic allocator - no individual deallocation
+    std::size_t overflow_count() const noexcept {
+        return m_state.overflow_count();
     }
-    
+
+    /**
+     * Statistics of this copy of the allocator: bytes requested, allocation
+     * count, peak used(), bytes freed but not reclaimed and overflows. All
+     * zero unless STACK_STRING_ALLOCATOR_STATS is defined.
+     */
+    allocator_stats stats() const noexcept {
+        return m_state.stats();
+    }
+
     /**
      * Rebind allocator to different type
      */
     template <typename U>
     struct rebind {
-        using other = FixedBufAllocator<U>;
+        using other = FixedBufAllocator<U, Overflow>;
     };
-    
+
     // Allow access to members from other instantiations
-    template <typename U>
+    template <typename U, typename O>
     friend class FixedBufAllocator;
+
+    template <typename U, typename V, typename O>
+    friend bool operator==(const FixedBufAllocator<U, O>& a, const FixedBufAllocator<V, O>& b) noexcept;
 };
 
 /**
  * Equality comparison for allocators
  * Two allocators are equal if they share the same buffer
  */
-template <typename T, typename U>
-bool operator==(const FixedBufAllocator<T>& a, const FixedBufAllocator<U>& b) noexcept {
-    return a.m_buffer == b.m_buffer;
+template <typename T, typename U, typename O>
+bool operator==(const FixedBufAllocator<T, O>& a, const FixedBufAllocator<U, O>& b) noexcept {
+    return a.m_state.buffer() == b.m_state.buffer();
+}
+
+template <typename T, typename U, typename O>
+bool operator!=(const FixedBufAllocator<T, O>& a, const FixedBufAllocator<U, O>& b) noexcept {
+    return !(a == b);
+}
+
+namespace detail {
+
+// Bytes BufferString<N> reserves: N rounded up to 16 and at least 32, so the
+// single reserve() fits the capacity rounding of libstdc++, libc++ and MSVC
+constexpr std::size_t buffer_string_bytes(std::size_t n) noexcept {
+    return n < 32 ? 32 : (n + 15) / 16 * 16;
+}
+
+// Declared as the first base so the buffer exists before the string
+template <std::size_t Bytes>
+struct BufferStringStorage {
+    char m_buffer[Bytes];
+};
+
+} // namespace detail
+
+/**
+ * A std::basic_string over its own inline buffer: the ready-made form of
+ * std::basic_string<char, std::char_traits<char>, FixedBufAllocator<char>>.
+ * The whole buffer is reserved at construction, so the string never
+ * reallocates while it holds at most capacity() (at least N - 1) characters
+ * and sizeof is fixed. Growing past that goes to the Overflow policy.
+ *
+ * The std::basic_string is a private base: its allocator points into this
+ * object, so a copy of it (or an assignment that propagates it) would write
+ * into a buffer it does not own. Only the read accessors, the mutators and
+ * a std::string_view conversion are exposed; copies and moves copy the
+ * characters into the target's own buffer.
+ *
+ * @tparam N Buffer size in bytes, including the terminator
+ * @tparam Overflow What to do when the string outgrows the buffer
+ */
+template <std::size_t N, typename Overflow = NullOnOverflow>
+class BufferString
+    : private detail::BufferStringStorage<detail::buffer_string_bytes(N)>
+    , private std::basic_string<char, std::char_traits<char>, FixedBufAllocator<char, Overflow>> {
+private:
+    using storage_type = detail::BufferStringStorage<detail::buffer_string_bytes(N)>;
+
+    // Other types the comparisons take as text
+    template <typename T>
+    static constexpr bool is_text =
+        std::is_convertible_v<const T&, std::string_view> && !std::is_same_v<T, BufferString>;
+
+public:
+    using string_type = std::basic_string<char, std::char_traits<char>, FixedBufAllocator<char, Overflow>>;
+    using allocator_type = FixedBufAllocator<char, Overflow>;
+
+    using typename string_type::const_iterator;
+    using typename string_type::const_pointer;
+    using typename string_type::const_reference;
+    using typename string_type::const_reverse_iterator;
+    using typename string_type::difference_type;
+    using typename string_type::iterator;
+    using typename string_type::pointer;
+    using typename string_type::reference;
+    using typename string_type::reverse_iterator;
+    using typename string_type::size_type;
+    using typename string_type::traits_type;
+    using typename string_type::value_type;
+
+    using string_type::npos;
+
+    static constexpr std::size_t buffer_size = detail::buffer_string_bytes(N);
+
+    // The buffer is left uninitialized
+    BufferString()
+        : string_type(allocator_type(this->m_buffer, buffer_size)) {
+        string_type::reserve(buffer_size - 1);
+    }
+
+    BufferString(std::string_view sv)
+        : BufferString() {
+        string_type::assign(sv.data(), sv.size());
+    }
+
+    BufferString(const char* str)
+        : BufferString(std::string_view(str)) {}
+
+    BufferString(std::size_t count, char c)
+        : BufferString() {
+        string_type::assign(count, c);
+    }
+
+    BufferString(const BufferString& other)
+        : BufferString(other.view()) {}
+
+    // Moving cannot take over the other buffer, so it copies
+    BufferString(BufferString&& other)
+        : BufferString(other.view()) {}
+
+    BufferString& operator=(const BufferString& other) {
+        if (this != &other) {
+            string_type::assign(other.data(), other.size());
+        }
+        return *this;
+    }
+
+    BufferString& operator=(BufferString&& other) {
+        return *this = static_cast<const BufferString&>(other);
+    }
+
+    BufferString& operator=(std::string_view sv) {
+        string_type::assign(sv.data(), sv.size());
+        return *this;
+    }
+
+    BufferString& operator=(const char* str) {
+        return *this = std::string_view(str);
+    }
+
+    BufferString& operator=(char c) {
+        string_type::assign(1, c);
+        return *this;
+    }
+
+    using string_type::at;
+    using string_type::back;
+    using string_type::begin;
+    using string_type::c_str;
+    using string_type::capacity;
+    using string_type::cbegin;
+    using string_type::cend;
+    using string_type::clear;
+    using string_type::compare;
+    using string_type::copy;
+    using string_type::crbegin;
+    using string_type::crend;
+    using string_type::data;
+    using string_type::empty;
+    using string_type::end;
+    using string_type::find;
+    using string_type::find_first_not_of;
+    using string_type::find_first_of;
+    using string_type::find_last_not_of;
+    using string_type::find_last_of;
+    using string_type::front;
+    using string_type::get_allocator;  // For overflow_count() and stats()
+    using string_type::length;
+    using string_type::max_size;
+    using string_type::operator[];
+    using string_type::pop_back;
+    using string_type::push_back;
+    using string_type::rbegin;
+    using string_type::rend;
+    using string_type::resize;
+    using string_type::rfind;
+    using string_type::size;
+
+    // The mutators of std::basic_string, returning *this rather than the
+    // base. A BufferString or string_type argument is passed as its
+    // characters, never as a string whose allocator could be copied.
+    template <typename... Args>
+    decltype(auto) append(Args&&... args) {
+        return chain(string_type::append(pass(std::forward<Args>(args))...));
+    }
+
+    template <typename... Args>
+    decltype(auto) assign(Args&&... args) {
+        return chain(string_type::assign(pass(std::forward<Args>(args))...));
+    }
+
+    template <typename... Args>
+    decltype(auto) insert(Args&&... args) {
+        return chain(string_type::insert(pass(std::forward<Args>(args))...));
+    }
+
+    template <typename... Args>
+    decltype(auto) erase(Args&&... args) {
+        return chain(string_type::erase(std::forward<Args>(args)...));
+    }
+
+    template <typename... Args>
+    decltype(auto) replace(Args&&... args) {
+        return chain(string_type::replace(pass(std::forward<Args>(args))...));
+    }
+
+    template <typename T>
+    BufferString& operator+=(T&& t) {
+        string_type::operator+=(pass(std::forward<T>(t)));
+        return *this;
+    }
+
+    // Swap contents; the buffers stay where they are
+    void swap(BufferString& other) {
+        BufferString tmp(*this);
+        *this = other;
+        other = tmp;
+    }
+
+    std::string_view view() const noexcept {
+        return std::string_view(data(), size());
+    }
+
+    operator std::string_view() const noexcept {
+        return view();
+    }
+
+    friend bool operator==(const BufferString& a, const BufferString& b) noexcept {
+        return a.view() == b.view();
+    }
+
+    // Against anything else that converts to std::string_view
+    template <typename T, typename = std::enable_if_t<is_text<T>>>
+    friend bool operator==(const BufferString& a, const T& b) noexcept {
+        return a.view() == std::string_view(b);
+    }
+
+    template <typename T, typename = std::enable_if_t<is_text<T>>>
+    friend bool operator==(const T& a, const BufferString& b) noexcept {
+        return std::string_view(a) == b.view();
+    }
+
+    friend bool operator!=(const BufferString& a, const BufferString& b) noexcept {
+        return !(a == b);
+    }
+
+    template <typename T, typename = std::enable_if_t<is_text<T>>>
+    friend bool operator!=(const BufferString& a, const T& b) noexcept {
+        return !(a == b);
+    }
+
+    template <typename T, typename = std::enable_if_t<is_text<T>>>
+    friend bool operator!=(const T& a, const BufferString& b) noexcept {
+        return !(a == b);
+    }
+
+    friend bool operator<(const BufferString& a, const BufferString& b) noexcept {
+        return a.view() < b.view();
+    }
+
+    template <typename Traits>
+    friend std::basic_ostream<char, Traits>& operator<<(std::basic_ostream<char, Traits>& os, const BufferString& s) {
+        return os << s.view();
+    }
+
+private:
+    template <typename T>
+    static decltype(auto) pass(T&& arg) noexcept {
+        if constexpr (std::is_base_of_v<string_type, std::decay_t<T>>) {
+            return std::string_view(arg.data(), arg.size());
+        } else {
+            return std::forward<T>(arg);
+        }
+    }
+
+    // The base returns string_type& from most mutators and iterators from
+    // some; hand back *this for the former
+    template <typename R>
+    decltype(auto) chain(R&& result) noexcept {
+        if constexpr (std::is_same_v<R, string_type&>) {
+            return static_cast<BufferString&>(*this);
+        } else {
+            return R(std::forward<R>(result));
+        }
+    }
+};
+
+template <std::size_t N, typename O>
+void swap(BufferString<N, O>& a, BufferString<N, O>& b) {
+    a.swap(b);
+}
+
+/**
+ * A monotonic arena over an external buffer: the control block that
+ * ArenaAllocator copies point to, so any number of containers (strings,
+ * vectors, maps) and their rebound allocators share one buffer without
+ * handing out overlapping memory. Like std::pmr::monotonic_buffer_resource
+ * without virtual dispatch or an upstream resource; allocation returns
+ * nullptr when the buffer is exhausted.
+ *
+ * The arena must outlive every container using it. It is not copyable,
+ * since a copy would duplicate the usage count.
+ */
+class FixedBufArena {
+public:
+    FixedBufArena(void* buffer, std::size_t capacity) noexcept
+        : m_state(buffer, capacity) {}
+
+    // Also report statistics to tag (with STACK_STRING_ALLOCATOR_STATS)
+    FixedBufArena(void* buffer, std::size_t capacity, allocator_stats_tag& tag) noexcept
+        : m_state(buffer, capacity, &tag) {}
+
+    FixedBufArena(const FixedBufArena&) = delete;
+    FixedBufArena& operator=(const FixedBufArena&) = delete;
+
+    void* allocate(std::size_t bytes, std::size_t alignment = alignof(std::max_align_t)) noexcept {
+        return m_state.allocate(bytes, alignment);
+    }
+
+    void deallocate(void* p, std::size_t bytes) noexcept {
+        m_state.deallocate(p, bytes);
+    }
+
+    bool expand(void* p, std::size_t old_bytes, std::size_t new_bytes) noexcept {
+        return m_state.expand(p, old_bytes, new_bytes);
+    }
+
+    bool owns(const void* p) const noexcept {
+        return m_state.owns(p);
+    }
+
+    std::size_t mark() const noexcept {
+        return m_state.mark();
+    }
+
+    void rewind(std::size_t mark) noexcept {
+        m_state.rewind(mark);
+    }
+
+    void reset() noexcept {
+        m_state.reset();
+    }
+
+    std::size_t used() const noexcept {
+        return m_state.used();
+    }
+
+    std::size_t capacity() const noexcept {
+        return m_state.capacity();
+    }
+
+    std::size_t overflow_count() const noexcept {
+        return m_state.overflow_count();
+    }
+
+    allocator_stats stats() const noexcept {
+        return m_state.stats();
+    }
+
+private:
+    detail::FixedBufState m_state;
+};
+
+/**
+ * Allocator handle for a FixedBufArena: a single pointer, so copies and
+ * rebinds are cheap and all of them allocate from the same usage count.
+ *
+ * @tparam T The type to allocate
+ * @tparam Overflow What to do when the arena is exhausted (see FixedBufAllocator)
+ */
+template <typename T, typename Overflow = NullOnOverflow>
+class ArenaAllocator {
+private:
+    FixedBufArena* m_arena;
+
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    // Implicit, so a container can be constructed directly from the arena
+    ArenaAllocator(FixedBufArena& arena) noexcept
+        : m_arena(&arena) {}
+
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U, Overflow>& other) noexcept
+        : m_arena(other.m_arena) {}
+
+    T* allocate(std::size_t n) {
+        return allocate(n, alignof(T));
+    }
+
+    // Over-aligned blocks, as for FixedBufAllocator
+    T* allocate(std::size_t n, std::size_t alignment) {
+        void* p = m_arena->allocate(n * sizeof(T), alignment);
+        return static_cast<T*>(p ? p : Overflow::allocate(n * sizeof(T), alignment));
+    }
+
+    void deallocate(T* p, std::size_t n) noexcept {
+        deallocate(p, n, alignof(T));
+    }
+
+    void deallocate(T* p, std::size_t n, std::size_t alignment) noexcept {
+        if (m_arena->owns(p)) {
+            m_arena->deallocate(p, n * sizeof(T));
+        } else {
+            Overflow::deallocate(p, n * sizeof(T), alignment);
+        }
+    }
+
+    bool expand(T* p, std::size_t old_n, std::size_t new_n) noexcept {
+        return m_arena->expand(p, old_n * sizeof(T), new_n * sizeof(T));
+    }
+
+    FixedBufArena& arena() const noexcept {
+        return *m_arena;
+    }
+
+    template <typename U>
+    struct rebind {
+        using other = ArenaAllocator<U, Overflow>;
+    };
+
+    template <typename U, typename O>
+    friend class ArenaAllocator;
+};
+
+// Equal if they draw from the same arena
+template <typename T, typename U, typename O>
+bool operator==(const ArenaAllocator<T, O>& a, const ArenaAllocator<U, O>& b) noexcept {
+    return &a.arena() == &b.arena();
 }
 
-template <typename T, typename U>
-bool operator!=(const FixedBufAllocator<T>& a, const FixedBufAllocator<U>& b) noexcept {
+template <typename T, typename U, typename O>
+bool operator!=(const ArenaAllocator<T, O>& a, const ArenaAllocator<U, O>& b) noexcept {
     return !(a == b);
 }
 
@@ -1,107 +1,627 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
 #include <cstring>
+#include <functional>
 #include <string_view>
 #include <type_traits>
 #include <algorithm>
 #include <charconv>
 #include <system_error>
 
+#if defined(__cpp_impl_three_way_comparison) && __has_include(<compare>)
+#include <compare>
+#endif
+
+#include "stack_string_digits.hpp"
+#include "stack_string_hash.hpp"
+#include "stack_string_parse.hpp"
+#include "stack_string_simd.hpp"
+#include "stack_string_stats.hpp"
+
 namespace stack_string {
 
 // Maximum number of characters needed to represent any integer in decimal
 // (20 digits for uint64_t max value: 18,446,744,073,709,551,615)
 constexpr std::size_t max_integer_decimal_chars = 20;
 
+/**
+ * Compile-time options for StackString, combinable with operator|.
+ */
+enum class Options : unsigned {
+    None = 0,
+    // Store the remaining capacity in the last byte of the buffer instead of a
+    // separate size member, so that sizeof(StackString<N>) == N + 1 (N <= 255)
+    Compact = 1u << 0,
+    // Use defaulted (trivial) copy and move so the type is trivially copyable
+    // and can be relocated with memcpy; copies then move the whole buffer
+    TriviallyCopyable = 1u << 1,
+    // Keep a sticky truncated() flag, set by any append that drops characters
+    TrackTruncation = 1u << 2,
+};
+
+constexpr Options operator|(Options a, Options b) noexcept {
+    return static_cast<Options>(static_cast<unsigned>(a) | static_cast<unsigned>(b));
+}
+
+constexpr bool has_option(Options opts, Options flag) noexcept {
+    return (static_cast<unsigned>(opts) & static_cast<unsigned>(flag)) != 0;
+}
+
+/**
+ * A floating-point value paired with a std::chars_format and precision.
+ * Created by fixed(), scientific() and general(); usable with append()
+ * and operator<<.
+ */
+template <typename T>
+struct FormattedFloat {
+    T value;
+    std::chars_format format;
+    int precision;
+};
+
+template <typename T, typename = std::enable_if_t<std::is_floating_point_v<T>>>
+constexpr FormattedFloat<T> fixed(T value, int precision) noexcept {
+    return {value, std::chars_format::fixed, precision};
+}
+
+template <typename T, typename = std::enable_if_t<std::is_floating_point_v<T>>>
+constexpr FormattedFloat<T> scientific(T value, int precision) noexcept {
+    return {value, std::chars_format::scientific, precision};
+}
+
+template <typename T, typename = std::enable_if_t<std::is_floating_point_v<T>>>
+constexpr FormattedFloat<T> general(T value, int precision) noexcept {
+    return {value, std::chars_format::general, precision};
+}
+
+/**
+ * Integer manipulators for append() and operator<<: hex(x) for hexadecimal,
+ * pad<6>(x) for zero padding to a width known at compile time, and
+ * pad(x, width, fill) for a run-time width and fill character.
+ */
+template <typename T>
+struct HexInt {
+    T value;
+    std::size_t width;
+    bool uppercase;
+};
+
+template <typename T>
+struct PaddedInt {
+    T value;
+    std::size_t width;
+    char fill;
+};
+
+template <typename T, std::size_t Width>
+struct FixedWidthInt {
+    T value;
+};
+
+template <typename T, typename = std::enable_if_t<std::is_integral_v<T>>>
+constexpr HexInt<T> hex(T value, std::size_t width = 0, bool uppercase = false) noexcept {
+    return {value, width, uppercase};
+}
+
+template <std::size_t Width, typename T, typename = std::enable_if_t<std::is_integral_v<T>>>
+constexpr FixedWidthInt<T, Width> pad(T value) noexcept {
+    return {value};
+}
+
+template <typename T, typename = std::enable_if_t<std::is_integral_v<T>>>
+constexpr PaddedInt<T> pad(T value, std::size_t width, char fill = '0') noexcept {
+    return {value, width, fill};
+}
+
+namespace detail {
+
+// C++20 lets a constexpr constructor leave members uninitialized, so storage
+// can zero its buffer only while constant evaluated. C++17 has no such
+// constructor without zeroing at run time too; there the implicit one is kept.
+#if defined(__cpp_constexpr) && __cpp_constexpr >= 201907L
+#define STACK_STRING_CONSTEXPR_STORAGE 1
+#else
+#define STACK_STRING_CONSTEXPR_STORAGE 0
+#endif
+
+// Smallest unsigned type able to hold a length in [0, N]
+template <std::size_t N>
+using size_type_for = std::conditional_t<(N <= UINT8_MAX), std::uint8_t,
+                      std::conditional_t<(N <= UINT16_MAX), std::uint16_t,
+                      std::conditional_t<(N <= UINT32_MAX), std::uint32_t,
+                                         std::uint64_t>>>;
+
+// memcpy at run time; a plain loop during constant evaluation
+constexpr char* copy_chars(char* out, const char* src, std::size_t n) noexcept {
+    if (!is_constant_evaluated()) {
+        if (n) std::memcpy(out, src, n);
+        return out + n;
+    }
+    for (std::size_t i = 0; i < n; ++i) {
+        out[i] = src[i];
+    }
+    return out + n;
+}
+
+// memmove at run time; a plain loop in the safe direction during constant
+// evaluation
+constexpr char* move_chars(char* out, const char* src, std::size_t n) noexcept {
+    if (!is_constant_evaluated()) {
+        if (n) std::memmove(out, src, n);
+        return out + n;
+    }
+    if (out < src) {
+        for (std::size_t i = 0; i < n; ++i) out[i] = src[i];
+    } else {
+        for (std::size_t i = n; i-- > 0;) out[i] = src[i];
+    }
+    return out + n;
+}
+
+// Default set for trim(): the characters std::isspace accepts in the C locale
+constexpr std::string_view ascii_whitespace = " \t\n\v\f\r";
+
+// memset at run time; a plain loop during constant evaluation
+constexpr char* fill_chars(char* out, char c, std::size_t n) noexcept {
+    if (!is_constant_evaluated()) {
+        if (n) std::memset(out, c, n);
+        return out + n;
+    }
+    for (std::size_t i = 0; i < n; ++i) {
+        out[i] = c;
+    }
+    return out + n;
+}
+
+/**
+ * Character buffer plus an explicit size member of the narrowest type for N.
+ */
+template <std::size_t N, bool Compact>
+class StackStringStorage {
+protected:
+#if STACK_STRING_CONSTEXPR_STORAGE
+    // A constant-evaluated object must have every byte initialized; at run
+    // time the bytes past the terminator are left alone
+    constexpr StackStringStorage() noexcept {
+        if (is_constant_evaluated()) {
+            fill_chars(m_data, '\0', N + 1);
+            m_size = 0;
+        }
+    }
+#endif
+
+    constexpr std::size_t get_size() const noexcept {
+        return m_size;
+    }
+
+    // Update the size and write the null terminator
+    constexpr void set_size(std::size_t size) noexcept {
+        m_size = static_cast<size_type_for<N>>(size);
+        m_data[size] = '\0';
+    }
+
+    // Copy only the used bytes and the terminator
+    constexpr void copy_from(const StackStringStorage& other) noexcept {
+        copy_chars(m_data, other.m_data, other.m_size + 1);
+        m_size = other.m_size;
+    }
+
+    char m_data[N + 1]; // +1 for null terminator
+    size_type_for<N> m_size;
+};
+
+/**
+ * Compact layout: the last byte holds the remaining capacity (N - size).
+ * When the string holds N characters it reads 0 and doubles as the terminator.
+ */
+template <std::size_t N>
+class StackStringStorage<N, true> {
+    static_assert(N <= UINT8_MAX, "Options::Compact requires N <= 255");
+
+protected:
+#if STACK_STRING_CONSTEXPR_STORAGE
+    constexpr StackStringStorage() noexcept {
+        if (is_constant_evaluated()) {
+            fill_chars(m_data, '\0', N + 1);
+        }
+    }
+#endif
+
+    constexpr std::size_t get_size() const noexcept {
+        return N - static_cast<unsigned char>(m_data[N]);
+    }
+
+    // Update the size and write the null terminator
+    constexpr void set_size(std::size_t size) noexcept {
+        m_data[N] = static_cast<char>(N - size);
+        m_data[size] = '\0';
+    }
+
+    // Copy only the used bytes and the terminator
+    constexpr void copy_from(const StackStringStorage& other) noexcept {
+        std::size_t size = other.get_size();
+        copy_chars(m_data, other.m_data, size + 1);
+        m_data[N] = other.m_data[N];
+    }
+
+    char m_data[N + 1]; // +1 for null terminator, last byte holds N - size
+};
+
+/**
+ * Truncation layer: a sticky flag for Options::TrackTruncation. Without the
+ * option it holds nothing and set_truncated() compiles away.
+ */
+template <typename Storage, bool Track>
+class StackStringTruncation : public Storage {
+protected:
+    constexpr bool get_truncated() const noexcept {
+        return false;
+    }
+
+    constexpr void set_truncated(bool) noexcept {}
+};
+
+template <typename Storage>
+class StackStringTruncation<Storage, true> : public Storage {
+protected:
+    constexpr bool get_truncated() const noexcept {
+        return m_truncated;
+    }
+
+    constexpr void set_truncated(bool truncated) noexcept {
+        m_truncated = truncated;
+    }
+
+    constexpr void copy_from(const StackStringTruncation& other) noexcept {
+        Storage::copy_from(other);
+        m_truncated = other.m_truncated;
+    }
+
+    bool m_truncated = false;
+};
+
+/**
+ * Copy layer: copies touch only the used bytes. Moving an inline buffer is no
+ * cheaper than copying it, so moves are copies and leave the source intact.
+ */
+template <typename Storage, bool Trivial>
+class StackStringCopyBase : public Storage {
+protected:
+    // The layers below: trivially copyable whatever the options
+    using layout_type = Storage;
+
+    constexpr StackStringCopyBase() noexcept = default;
+
+    constexpr StackStringCopyBase(const StackStringCopyBase& other) noexcept {
+        this->copy_from(other);
+    }
+
+    constexpr StackStringCopyBase& operator=(const StackStringCopyBase& other) noexcept {
+        if (this != &other) {
+            this->copy_from(other);
+        }
+        return *this;
+    }
+};
+
+// Options::TriviallyCopyable: defaulted copy/move of the whole buffer
+template <typename Storage>
+class StackStringCopyBase<Storage, true> : public Storage {
+protected:
+    using layout_type = Storage;
+};
+
+// Pointer-to-char arguments. The const char* overloads are templates so that
+// the character-array overloads win partial ordering for string literals.
+template <typename T>
+constexpr bool is_c_string_v = std::is_same_v<T, const char*> || std::is_same_v<T, char*>;
+
+// Length of the C string in a character array without reading past its end.
+// For string literals the compiler folds this to a constant.
+template <std::size_t M>
+constexpr std::size_t array_string_length(const char (&str)[M]) noexcept {
+    if (str[M - 1] == '\0') {
+        return std::char_traits<char>::length(str);
+    }
+    std::size_t len = 0;
+    while (len < M && str[len] != '\0') {
+        ++len;
+    }
+    return len;
+}
+
+template <std::size_t N, Options Opts>
+using StackStringBase = StackStringCopyBase<
+    StackStringTruncation<StackStringStorage<N, has_option(Opts, Options::Compact)>,
+                          has_option(Opts, Options::TrackTruncation)>,
+    has_option(Opts, Options::TriviallyCopyable)>;
+
+constexpr std::size_t concat_unbounded = static_cast<std::size_t>(-1);
+
+constexpr std::size_t concat_add(std::size_t a, std::size_t b) noexcept {
+    return a > concat_unbounded - b ? concat_unbounded : a + b;
+}
+
+/*
+ * Pieces of a concatenation expression built by operator+. Each knows its
+ * exact size() and a compile-time bound, max_size; write() copies all of
+ * it, and write_prefix() copies at most room bytes and takes them off room.
+ */
+template <std::size_t Max = concat_unbounded>
+struct ConcatText {
+    static constexpr std::size_t max_size = Max;
+
+    const char* m_data;
+    std::size_t m_size;
+
+    constexpr std::size_t size() const noexcept {
+        return m_size;
+    }
+
+    constexpr char* write(char* out) const noexcept {
+        return copy_chars(out, m_data, m_size);
+    }
+
+    constexpr char* write_prefix(char* out, std::size_t& room) const noexcept {
+        std::size_t n = m_size < room ? m_size : room;
+        if constexpr (Max != concat_unbounded) {
+            n = n < Max ? n : Max;  // Lets the compiler bound the copy
+        }
+        room -= n;
+        return copy_chars(out, m_data, n);
+    }
+};
+
+struct ConcatChar {
+    static constexpr std::size_t max_size = 1;
+
+    char m_c;
+
+    constexpr std::size_t size() const noexcept {
+        return 1;
+    }
+
+    constexpr char* write(char* out) const noexcept {
+        *out = m_c;
+        return out + 1;
+    }
+
+    constexpr char* write_prefix(char* out, std::size_t& room) const noexcept {
+        if (room == 0) return out;
+        --room;
+        return write(out);
+    }
+};
+
+// An integer, formatted in decimal when the expression is built
+template <typename T>
+struct ConcatInteger {
+    static constexpr std::size_t max_size = max_integer_decimal_chars + 1;
+
+    constexpr explicit ConcatInteger(T value) noexcept : m_buf(), m_size(0) {
+        char* end = m_buf + sizeof(m_buf);
+        char* ptr = is_constant_evaluated() ? integer_to_chars(m_buf, end, value)
+                                            : std::to_chars(m_buf, end, value).ptr;  // Always fits
+        m_size = static_cast<unsigned char>(ptr - m_buf);
+    }
+
+    constexpr std::size_t size() const noexcept {
+        return m_size;
+    }
+
+    constexpr char* write(char* out) const noexcept {
+        return ConcatText<max_size>{m_buf, m_size}.write(out);
+    }
+
+    constexpr char* write_prefix(char* out, std::size_t& room) const noexcept {
+        return ConcatText<max_size>{m_buf, m_size}.write_prefix(out, room);
+    }
+
+    char m_buf[max_size];  // Digits and sign
+    unsigned char m_size;
+};
+
+/**
+ * Lazy concatenation: the operands of a chain of operator+ held as pieces
+ * (text is referenced, not copied). Assigning or appending it to a
+ * StackString sizes the result once, copies every piece and writes the
+ * terminator once. Materialize it in the same full-expression, since it
+ * refers to its operands.
+ */
+template <typename L, typename R>
+struct ConcatExpr {
+    static constexpr std::size_t max_size = concat_add(L::max_size, R::max_size);
+
+    L m_left;
+    R m_right;
+
+    constexpr std::size_t size() const noexcept {
+        return m_left.size() + m_right.size();
+    }
+
+    constexpr char* write(char* out) const noexcept {
+        return m_right.write(m_left.write(out));
+    }
+
+    constexpr char* write_prefix(char* out, std::size_t& room) const noexcept {
+        return m_right.write_prefix(m_left.write_prefix(out, room), room);
+    }
+};
+
+template <typename T>
+struct is_concat_expr : std::false_type {};
+
+template <typename L, typename R>
+struct is_concat_expr<ConcatExpr<L, R>> : std::true_type {};
+
+} // namespace detail
+
 /**
  * A fixed-capacity string that uses stack-allocated memory.
  * Similar to std::string but with pre-allocated storage on the stack.
  * 
  * @tparam N Maximum capacity (excluding null terminator)
+ * @tparam Opts Layout options (see Options)
  */
-template <std::size_t N>
-class StackString {
+template <std::size_t N, Options Opts = Options::None>
+class StackString : private detail::StackStringBase<N, Opts> {
+    using Base = detail::StackStringBase<N, Opts>;
+    using Base::m_data;
+    using Base::get_size;
+    using Base::get_truncated;
+#if defined(STACK_STRING_STATS)
+    // Every write also updates the counters of this type or of the tag in
+    // scope (stack_string_stats.hpp), except in constant expressions
+    constexpr void set_size(std::size_t size) noexcept {
+        Base::set_size(size);
+        if (size > 0 && !detail::is_constant_evaluated()) {
+            detail::string_stats_record_size<N, static_cast<unsigned>(Opts)>(size);
+        }
+    }
+
+    constexpr void set_truncated(bool truncated) noexcept {
+        Base::set_truncated(truncated);
+        if (truncated && !detail::is_constant_evaluated()) {
+            detail::string_stats_record_truncation<N, static_cast<unsigned>(Opts)>();
+        }
+    }
+#else
+    using Base::set_size;
+    using Base::set_truncated;
+#endif
+
 public:
     static constexpr std::size_t capacity = N;
+    static constexpr Options options = Opts;
 
     // Constructors
-    constexpr StackString() noexcept : m_size(0) {
-        m_data[0] = '\0';
+    constexpr StackString() noexcept {
+        set_size(0);
     }
 
-    constexpr StackString(const char* str) : m_size(0) {
+    template <typename T, typename = std::enable_if_t<detail::is_c_string_v<T>>>
+    constexpr StackString(T str) {
+        set_size(0);
         append(str);
     }
 
-    constexpr StackString(std::string_view sv) : m_size(0) {
-        append(sv);
+    // From a string literal: no truncation check when it always fits (an
+    // array of N chars may hold N characters with no terminator)
+    template <std::size_t M>
+    constexpr StackString(const char (&str)[M]) {
+        std::size_t len = detail::array_string_length(str);
+        if constexpr (M < N) {
+            assign_unchecked(str, len);
+        } else {
+            set_size(0);
+            append(std::string_view(str, len));
+        }
     }
 
-    template <typename... Args,
-              typename = std::enable_if_t<(sizeof...(Args) > 1)>>
-    constexpr StackString(Args&&... args) : m_size(0) {
-        m_data[0] = '\0';
-        (append(std::forward<Args>(args)), ...);
+    // From a StackString of another capacity or layout
+    template <std::size_t M, Options O>
+    constexpr StackString(const StackString<M, O>& other) {
+        if constexpr (M < N) {
+            assign_unchecked(other.data(), other.size());
+        } else {
+            set_size(0);
+            append(std::string_view(other.data(), other.size()));
+        }
     }
 
-    // Copy and move constructors
-    constexpr StackString(const StackString& other) noexcept : m_size(other.m_size) {
-        std::copy(other.m_data, other.m_data + m_size + 1, m_data);
+    constexpr StackString(std::string_view sv) {
+        set_size(0);
+        append(sv);
     }
 
-    constexpr StackString& operator=(const StackString& other) noexcept {
-        if (this != &other) {
-            m_size = other.m_size;
-            std::copy(other.m_data, other.m_data + m_size + 1, m_data);
+    // From a concatenation, e.g. StackString<64>(a + ":" + b + ":" + 42)
+    template <typename L, typename R>
+    constexpr StackString(const detail::ConcatExpr<L, R>& expr) {
+        if constexpr (detail::ConcatExpr<L, R>::max_size < N) {
+            // Always fits: no capacity check at all
+            set_size(static_cast<std::size_t>(expr.write(m_data) - m_data));
+        } else {
+            write_concat(0, expr);
         }
-        return *this;
     }
 
-    constexpr StackString(StackString&& other) noexcept : m_size(other.m_size) {
-        std::copy(other.m_data, other.m_data + m_size + 1, m_data);
-        other.clear();
+    template <typename... Args,
+              typename = std::enable_if_t<(sizeof...(Args) > 1)>>
+    constexpr StackString(Args&&... args) {
+        set_size(0);
+        (append(std::forward<Args>(args)), ...);
     }
 
-    constexpr StackString& operator=(StackString&& other) noexcept {
-        if (this != &other) {
-            m_size = other.m_size;
-            std::copy(other.m_data, other.m_data + m_size + 1, m_data);
-            other.clear();
-        }
-        return *this;
-    }
+    // Copy and move are provided by the base: copies touch only the used
+    // bytes, moves are copies, and Options::TriviallyCopyable defaults both
 
     // Append operations
-    constexpr StackString& append(const char* str) {
+    template <typename T>
+    constexpr std::enable_if_t<detail::is_c_string_v<T>, StackString&>
+    append(T str) {
         if (!str) return *this;
         // Reserve space for null terminator
-        std::size_t len = std::strlen(str);
-        std::size_t space_available = (N > 0 ? N - 1 : 0) - m_size;
+        std::size_t len = std::char_traits<char>::length(str);
+        std::size_t size = get_size();
+        std::size_t space_available = (N > 0 ? N - 1 : 0) - size;
         std::size_t to_copy = (len > space_available) ? space_available : len;
-        std::copy(str, str + to_copy, m_data + m_size);
-        m_size += to_copy;
-        m_data[m_size] = '\0';
+        detail::copy_chars(m_data + size, str, to_copy);
+        set_size(size + to_copy);
+        if (to_copy < len) set_truncated(true);
         return *this;
     }
 
+    // Append a string literal; its length is a compile-time constant
+    template <std::size_t M>
+    constexpr StackString& append(const char (&str)[M]) {
+        return append(std::string_view(str, detail::array_string_length(str)));
+    }
+
+    // Append another StackString without going through strlen
+    template <std::size_t M, Options O>
+    constexpr StackString& append(const StackString<M, O>& other) {
+        return append(std::string_view(other.data(), other.size()));
+    }
+
     constexpr StackString& append(std::string_view sv) {
         // Reserve space for null terminator
-        std::size_t space_available = (N > 0 ? N - 1 : 0) - m_size;
+        std::size_t size = get_size();
+        std::size_t space_available = (N > 0 ? N - 1 : 0) - size;
         std::size_t to_copy = (sv.size() > space_available) ? space_available : sv.size();
-        std::copy(sv.begin(), sv.begin() + to_copy, m_data + m_size);
-        m_size += to_copy;
-        m_data[m_size] = '\0';
+        detail::copy_chars(m_data + size, sv.data(), to_copy);
+        set_size(size + to_copy);
+        if (to_copy < sv.size()) set_truncated(true);
         return *this;
     }
 
     constexpr StackString& append(char c) {
         // Reserve space for null terminator
-        if (m_size >= (N > 0 ? N - 1 : 0)) {
+        std::size_t size = get_size();
+        if (size >= (N > 0 ? N - 1 : 0)) {
+            set_truncated(true);
             return *this;
         }
-        m_data[m_size++] = c;
-        m_data[m_size] = '\0';
+        m_data[size] = c;
+        set_size(size + 1);
+        return *this;
+    }
+
+    // Append a concatenation with one capacity check and one terminator
+    template <typename L, typename R>
+    constexpr StackString& append(const detail::ConcatExpr<L, R>& expr) {
+        write_concat(get_size(), expr);
+        return *this;
+    }
+
+    // Append count copies of c (named apart from append(value, base))
+    constexpr StackString& append_fill(std::size_t count, char c) {
+        std::size_t size = get_size();
+        std::size_t to_fill = (count > available()) ? available() : count;
+        detail::fill_chars(m_data + size, c, to_fill);
+        set_size(size + to_fill);
+        if (to_fill < count) set_truncated(true);
         return *this;
     }
 
@@ -109,21 +629,188 @@ public:
     template <typename T>
     constexpr std::enable_if_t<std::is_integral_v<T>, StackString&>
     append(T value) {
-        // Reserve space for null terminator
-        char* end = m_data + (N > 0 ? N - 1 : 0);
-        auto [ptr, ec] = std::to_chars(m_data + m_size, end, value);
-        if (ec == std::errc()) {
-            m_size = ptr - m_data;
-            m_data[m_size] = '\0';
-        }
+        return append_to_chars(value);
+    }
+
+    // Append integer types in the given base (2 to 36, lowercase digits)
+    template <typename T>
+    constexpr std::enable_if_t<std::is_integral_v<T>, StackString&>
+    append(T value, int base) {
+        return append_to_chars(value, base);
+    }
+
+    // Append floating-point types (shortest round-trip representation)
+    template <typename T>
+    std::enable_if_t<std::is_floating_point_v<T>, StackString&>
+    append(T value) {
+        return append_to_chars(value);
+    }
+
+    template <typename T>
+    std::enable_if_t<std::is_floating_point_v<T>, StackString&>
+    append(T value, std::chars_format fmt) {
+        return append_to_chars(value, fmt);
+    }
+
+    template <typename T>
+    std::enable_if_t<std::is_floating_point_v<T>, StackString&>
+    append(T value, std::chars_format fmt, int precision) {
+        return append_to_chars(value, fmt, precision);
+    }
+
+    template <typename T>
+    StackString& append(const FormattedFloat<T>& f) {
+        return append_to_chars(f.value, f.format, f.precision);
+    }
+
+    // Append an integer in decimal, padded on the left with fill to at least
+    // width characters. With '0' the sign comes first ("-0042"), otherwise
+    // the fill does ("  -42"). Nothing is written if the result doesn't fit.
+    template <typename T>
+    constexpr std::enable_if_t<std::is_integral_v<T>, StackString&>
+    append_padded(T value, std::size_t width, char fill = '0') {
+        if (!write_padded(value, width, fill)) set_truncated(true);
+        return *this;
+    }
+
+    // Append an integer in hexadecimal, zero-padded to at least width digits.
+    // Signed values are written as their two's complement bit pattern.
+    template <typename T>
+    constexpr std::enable_if_t<std::is_integral_v<T>, StackString&>
+    append_hex(T value, std::size_t width = 0, bool uppercase = false) {
+        if (!write_hex(value, width, uppercase)) set_truncated(true);
+        return *this;
+    }
+
+    template <typename T>
+    constexpr StackString& append(const HexInt<T>& h) {
+        return append_hex(h.value, h.width, h.uppercase);
+    }
+
+    template <typename T>
+    constexpr StackString& append(const PaddedInt<T>& p) {
+        return append_padded(p.value, p.width, p.fill);
+    }
+
+    template <typename T, std::size_t Width>
+    constexpr StackString& append(const FixedWidthInt<T, Width>& p) {
+        if (!write_fixed_width<Width>(p.value)) set_truncated(true);
         return *this;
     }
 
+    // All-or-nothing appends: return false and leave the string unchanged
+    // (and the truncated() flag untouched) when the value does not fit
+    template <typename T>
+    [[nodiscard]] constexpr std::enable_if_t<detail::is_c_string_v<T>, bool>
+    try_append(T str) {
+        return !str || try_append(std::string_view(str));
+    }
+
+    template <std::size_t M>
+    [[nodiscard]] constexpr bool try_append(const char (&str)[M]) {
+        return try_append(std::string_view(str, detail::array_string_length(str)));
+    }
+
+    template <std::size_t M, Options O>
+    [[nodiscard]] constexpr bool try_append(const StackString<M, O>& other) {
+        return try_append(std::string_view(other.data(), other.size()));
+    }
+
+    [[nodiscard]] constexpr bool try_append(std::string_view sv) {
+        if (sv.size() > available()) {
+            return false;
+        }
+        std::size_t size = get_size();
+        detail::copy_chars(m_data + size, sv.data(), sv.size());
+        set_size(size + sv.size());
+        return true;
+    }
+
+    [[nodiscard]] constexpr bool try_append(char c) {
+        return try_append(std::string_view(&c, 1));
+    }
+
+    template <typename T>
+    [[nodiscard]] constexpr std::enable_if_t<std::is_integral_v<T>, bool>
+    try_append(T value) {
+        return write_to_chars(value);
+    }
+
+    template <typename T>
+    [[nodiscard]] constexpr std::enable_if_t<std::is_integral_v<T>, bool>
+    try_append(T value, int base) {
+        return write_to_chars(value, base);
+    }
+
+    template <typename T>
+    [[nodiscard]] std::enable_if_t<std::is_floating_point_v<T>, bool>
+    try_append(T value) {
+        return write_to_chars(value);
+    }
+
+    template <typename T>
+    [[nodiscard]] std::enable_if_t<std::is_floating_point_v<T>, bool>
+    try_append(T value, std::chars_format fmt) {
+        return write_to_chars(value, fmt);
+    }
+
+    template <typename T>
+    [[nodiscard]] std::enable_if_t<std::is_floating_point_v<T>, bool>
+    try_append(T value, std::chars_format fmt, int precision) {
+        return write_to_chars(value, fmt, precision);
+    }
+
+    template <typename T>
+    [[nodiscard]] bool try_append(const FormattedFloat<T>& f) {
+        return write_to_chars(f.value, f.format, f.precision);
+    }
+
+    template <typename T>
+    [[nodiscard]] constexpr bool try_append(const HexInt<T>& h) {
+        return write_hex(h.value, h.width, h.uppercase);
+    }
+
+    template <typename T>
+    [[nodiscard]] constexpr bool try_append(const PaddedInt<T>& p) {
+        return write_padded(p.value, p.width, p.fill);
+    }
+
+    template <typename T, std::size_t Width>
+    [[nodiscard]] constexpr bool try_append(const FixedWidthInt<T, Width>& p) {
+        return write_fixed_width<Width>(p.value);
+    }
+
+    // Options::TrackTruncation: true once any append has dropped characters.
+    // Chain appends freely and check once at the end.
+    template <bool Track = has_option(Opts, Options::TrackTruncation)>
+    constexpr bool truncated() const noexcept {
+        static_assert(Track, "truncated() requires Options::TrackTruncation");
+        return get_truncated();
+    }
+
+    template <bool Track = has_option(Opts, Options::TrackTruncation)>
+    constexpr void clear_truncated() noexcept {
+        static_assert(Track, "clear_truncated() requires Options::TrackTruncation");
+        set_truncated(false);
+    }
+
     // Operator overloads
-    constexpr StackString& operator+=(const char* str) {
+    template <typename T>
+    constexpr std::enable_if_t<detail::is_c_string_v<T>, StackString&>
+    operator+=(T str) {
         return append(str);
     }
 
+    template <std::size_t M>
+    constexpr StackString& operator+=(const char (&str)[M]) {
+        return append(str);
+    }
+
+    template <std::size_t M, Options O>
+    constexpr StackString& operator+=(const StackString<M, O>& other) {
+        return append(other);
+    }
+
     constexpr StackString& operator+=(std::string_view sv) {
         return append(sv);
     }
@@ -132,8 +819,13 @@ public:
         return append(c);
     }
 
+    template <typename L, typename R>
+    constexpr StackString& operator+=(const detail::ConcatExpr<L, R>& expr) {
+        return append(expr);
+    }
+
     template <typename T>
-    constexpr std::enable_if_t<std::is_integral_v<T>, StackString&>
+    constexpr std::enable_if_t<std::is_arithmetic_v<T>, StackString&>
     operator+=(T value) {
         return append(value);
     }
@@ -157,15 +849,15 @@ public:
     }
 
     constexpr std::size_t size() const noexcept {
-        return m_size;
+        return get_size();
     }
 
     constexpr std::size_t length() const noexcept {
-        return m_size;
+        return get_size();
     }
 
     constexpr bool empty() const noexcept {
-        return m_size == 0;
+        return get_size() == 0;
     }
 
     constexpr std::size_t max_size() const noexcept {
@@ -175,11 +867,11 @@ public:
 
     constexpr std::size_t available() const noexcept {
         // Reserve space for null terminator
-        return (N > 0 ? N - 1 : 0) - m_size;
+        return (N > 0 ? N - 1 : 0) - get_size();
     }
 
     constexpr operator std::string_view() const noexcept {
-        return std::string_view(m_data, m_size);
+        return std::string_view(m_data, get_size());
     }
 
     constexpr operator const char*() const noexcept {
@@ -208,14 +900,104 @@ public:
     constexpr const char* begin() const noexcept { return m_data; }
     constexpr const char* cbegin() const noexcept { return m_data; }
     
-    constexpr char* end() noexcept { return m_data + m_size; }
-    constexpr const char* end() const noexcept { return m_data + m_size; }
-    constexpr const char* cend() const noexcept { return m_data + m_size; }
+    constexpr char* end() noexcept { return m_data + get_size(); }
+    constexpr const char* end() const noexcept { return m_data + get_size(); }
+    constexpr const char* cend() const noexcept { return m_data + get_size(); }
+
+    // Search operations (std::string_view semantics, npos when not found).
+    // SIMD kernels may load up to the whole inline buffer; bytes past size()
+    // are masked off, so no tail or page-crossing handling is needed.
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+    constexpr std::size_t find(char c, std::size_t pos = 0) const noexcept {
+        return detail::find_char(m_data, get_size(), N + 1, c, pos);
+    }
+
+    constexpr std::size_t find(std::string_view sv, std::size_t pos = 0) const noexcept {
+        return detail::find_substr(m_data, get_size(), N + 1, sv, pos);
+    }
+
+    constexpr std::size_t rfind(char c, std::size_t pos = npos) const noexcept {
+        return detail::rfind_char(m_data, get_size(), N + 1, c, pos);
+    }
+
+    constexpr std::size_t rfind(std::string_view sv, std::size_t pos = npos) const noexcept {
+        return detail::rfind_substr(m_data, get_size(), N + 1, sv, pos);
+    }
+
+    constexpr std::size_t find_first_of(char c, std::size_t pos = 0) const noexcept {
+        return find(c, pos);
+    }
+
+    constexpr std::size_t find_first_of(std::string_view set, std::size_t pos = 0) const noexcept {
+        return detail::find_of(m_data, get_size(), N + 1, set, pos, true);
+    }
+
+    constexpr std::size_t find_first_not_of(char c, std::size_t pos = 0) const noexcept {
+        return detail::find_of(m_data, get_size(), N + 1, std::string_view(&c, 1), pos, false);
+    }
+
+    constexpr std::size_t find_first_not_of(std::string_view set, std::size_t pos = 0) const noexcept {
+        return detail::find_of(m_data, get_size(), N + 1, set, pos, false);
+    }
+
+    constexpr bool starts_with(char c) const noexcept {
+        return get_size() > 0 && m_data[0] == c;
+    }
 
-    // Modifiers
+    constexpr bool starts_with(std::string_view sv) const noexcept {
+        return sv.size() <= get_size() && std::string_view(m_data, sv.size()) == sv;
+    }
+
+    constexpr bool ends_with(char c) const noexcept {
+        return get_size() > 0 && m_data[get_size() - 1] == c;
+    }
+
+    constexpr bool ends_with(std::string_view sv) const noexcept {
+        std::size_t size = get_size();
+        return sv.size() <= size && std::string_view(m_data + size - sv.size(), sv.size()) == sv;
+    }
+
+    constexpr bool contains(char c) const noexcept {
+        return find(c) != npos;
+    }
+
+    constexpr bool contains(std::string_view sv) const noexcept {
+        return find(sv) != npos;
+    }
+
+    // Numeric parsing of the whole string (see stack_string_parse.hpp):
+    // parse<int>(), parse<unsigned>(16), parse<double>(std::chars_format::fixed)
+    template <typename T, typename... Args>
+    parse_result<T> parse(Args... args) const noexcept {
+        return stack_string::parse<T>(std::string_view(m_data, get_size()), args...);
+    }
+
+    // std::nullopt unless the whole string is a T
+    template <typename T>
+    std::optional<T> to() const noexcept {
+        return stack_string::to<T>(std::string_view(m_data, get_size()));
+    }
+
+    // Modifiers. clear() also resets the truncated() flag.
     constexpr void clear() noexcept {
-        m_size = 0;
-        m_data[0] = '\0';
+        set_size(0);
+        set_truncated(false);
+    }
+
+    // Exchange the whole buffers (and truncated() flags): a fixed-size copy
+    // each way, the same whatever either string holds
+    constexpr void swap(StackString& other) noexcept {
+        using layout = typename Base::layout_type;
+        layout& a = *this;
+        layout& b = other;
+        layout tmp = a;
+        a = b;
+        b = tmp;
+    }
+
+    friend constexpr void swap(StackString& a, StackString& b) noexcept {
+        a.swap(b);
     }
 
     constexpr void resize(std::size_t count, char ch = '\0') {
@@ -223,17 +1005,108 @@ public:
             count = N;
         }
         
-        if (count > m_size) {
-            std::fill(m_data + m_size, m_data + count, ch);
+        std::size_t size = get_size();
+        if (count > size) {
+            detail::fill_chars(m_data + size, ch, count - size);
         }
         
-        m_size = count;
-        m_data[m_size] = '\0';
+        set_size(count);
+    }
+
+    // Remove count characters (all when npos) starting at pos; pos past
+    // size() removes nothing
+    constexpr StackString& erase(std::size_t pos, std::size_t count = npos) noexcept {
+        std::size_t size = get_size();
+        if (pos >= size) {
+            return *this;
+        }
+        std::size_t removed = count < size - pos ? count : size - pos;
+        detail::move_chars(m_data + pos, m_data + pos + removed, size - pos - removed);
+        set_size(size - removed);
+        return *this;
+    }
+
+    // Insert sv before pos (clamped to size()). What no longer fits is cut
+    // from the end, as by append(), and sets truncated(). sv must not refer
+    // to this string's own buffer.
+    constexpr StackString& insert(std::size_t pos, std::string_view sv) {
+        std::size_t size = get_size();
+        pos = pos < size ? pos : size;
+        std::size_t room = (N > 0 ? N - 1 : 0) - pos;
+        std::size_t inserted = sv.size() < room ? sv.size() : room;
+        std::size_t kept = size - pos < room - inserted ? size - pos : room - inserted;
+        detail::move_chars(m_data + pos + inserted, m_data + pos, kept);
+        detail::copy_chars(m_data + pos, sv.data(), inserted);
+        set_size(pos + inserted + kept);
+        if (inserted < sv.size() || kept < size - pos) set_truncated(true);
+        return *this;
+    }
+
+    // Insert count copies of c before pos, truncating like insert(pos, sv)
+    constexpr StackString& insert(std::size_t pos, std::size_t count, char c) {
+        std::size_t size = get_size();
+        pos = pos < size ? pos : size;
+        std::size_t room = (N > 0 ? N - 1 : 0) - pos;
+        std::size_t inserted = count < room ? count : room;
+        std::size_t kept = size - pos < room - inserted ? size - pos : room - inserted;
+        detail::move_chars(m_data + pos + inserted, m_data + pos, kept);
+        detail::fill_chars(m_data + pos, c, inserted);
+        set_size(pos + inserted + kept);
+        if (inserted < count || kept < size - pos) set_truncated(true);
+        return *this;
+    }
+
+    // Characters [pos, pos + count) as a new string of capacity M, cut to
+    // fit as by append(); empty when pos is past size()
+    template <std::size_t M = N>
+    constexpr StackString<M> substr(std::size_t pos, std::size_t count = npos) const {
+        std::size_t size = get_size();
+        pos = pos < size ? pos : size;
+        std::size_t len = count < size - pos ? count : size - pos;
+        return StackString<M>(std::string_view(m_data + pos, len));
+    }
+
+    // Remove leading / trailing characters found in set
+    constexpr StackString& ltrim(std::string_view set = detail::ascii_whitespace) noexcept {
+        std::size_t first = find_first_not_of(set);
+        return erase(0, first == npos ? get_size() : first);
+    }
+
+    constexpr StackString& rtrim(std::string_view set = detail::ascii_whitespace) noexcept {
+        std::size_t size = get_size();
+        while (size > 0 && set.find(m_data[size - 1]) != std::string_view::npos) {
+            --size;
+        }
+        set_size(size);
+        return *this;
+    }
+
+    constexpr StackString& trim(std::string_view set = detail::ascii_whitespace) noexcept {
+        return rtrim(set).ltrim(set);
+    }
+
+    // ASCII case mapping a block at a time; other bytes, including UTF-8
+    // sequences, are left as they are
+    constexpr StackString& to_lower() noexcept {
+        detail::transform_chars(m_data, get_size(), N + 1, detail::FlipRange{'A', 26, 0x20});
+        return *this;
+    }
+
+    constexpr StackString& to_upper() noexcept {
+        detail::transform_chars(m_data, get_size(), N + 1, detail::FlipRange{'a', 26, 0x20});
+        return *this;
     }
 
-    // Comparison operators
+    // Replace every from with to
+    constexpr StackString& replace(char from, char to) noexcept {
+        detail::transform_chars(m_data, get_size(), N + 1, detail::FlipEqual{from, static_cast<char>(from ^ to)});
+        return *this;
+    }
+
+    // Comparison operators. Across capacities and layouts, and for ordering,
+    // see the non-member operators below.
     constexpr bool operator==(const StackString& other) const noexcept {
-        return std::string_view(*this) == std::string_view(other);
+        return get_size() == other.get_size() && detail::equal_chars(m_data, other.m_data, get_size(), N + 1);
     }
 
     constexpr bool operator!=(const StackString& other) const noexcept {
@@ -256,9 +1129,400 @@ public:
         return !(*this == str);
     }
 
+    // Negative, zero or positive as this string orders before, equal to or
+    // after sv: bytes compared as unsigned char, then a prefix first
+    constexpr int compare(std::string_view sv) const noexcept {
+        return std::string_view(m_data, get_size()).compare(sv);
+    }
+
 private:
-    char m_data[N + 1]; // +1 for null terminator
-    std::size_t m_size;
+    // Replace the contents with len bytes known to fit in max_size()
+    constexpr void assign_unchecked(const char* str, std::size_t len) {
+        detail::copy_chars(m_data, str, len);
+        set_size(len);
+    }
+
+    // Write expr at offset size; when it doesn't fit, keep the leading part
+    template <typename L, typename R>
+    constexpr void write_concat(std::size_t size, const detail::ConcatExpr<L, R>& expr) {
+        std::size_t room = (N > 0 ? N - 1 : 0) - size;
+        std::size_t total = expr.size();
+        if (total <= room) {
+            expr.write(m_data + size);
+            set_size(size + total);
+        } else {
+            expr.write_prefix(m_data + size, room);
+            set_size(N > 0 ? N - 1 : 0);
+            set_truncated(true);
+        }
+    }
+
+    // Convert directly into m_data; nothing is written if the result doesn't fit.
+    // std::to_chars is not constexpr, so integers take a scalar path while
+    // constant evaluated.
+    template <typename... Args>
+    constexpr bool write_to_chars(Args... args) {
+        // Reserve space for null terminator
+        char* end = m_data + (N > 0 ? N - 1 : 0);
+        if constexpr ((std::is_integral_v<Args> && ...)) {
+            if (detail::is_constant_evaluated()) {
+                char* ptr = detail::integer_to_chars(m_data + get_size(), end, args...);
+                if (!ptr) {
+                    return false;
+                }
+                set_size(static_cast<std::size_t>(ptr - m_data));
+                return true;
+            }
+        }
+        auto [ptr, ec] = std::to_chars(m_data + get_size(), end, args...);
+        if (ec != std::errc()) {
+            return false;
+        }
+        set_size(static_cast<std::size_t>(ptr - m_data));
+        return true;
+    }
+
+    // Magnitude of value as an unsigned 64-bit number; negative set for
+    // negative signed values
+    template <typename T>
+    static constexpr std::uint64_t magnitude(T value, bool& negative) noexcept {
+        using U = std::make_unsigned_t<T>;
+        negative = false;
+        if constexpr (std::is_signed_v<T>) {
+            if (value < 0) {
+                negative = true;
+                return static_cast<std::uint64_t>(U(0) - static_cast<U>(value));
+            }
+        }
+        return static_cast<std::uint64_t>(static_cast<U>(value));
+    }
+
+    template <typename T>
+    constexpr bool write_padded(T value, std::size_t width, char fill) {
+        bool negative = false;
+        std::uint64_t mag = magnitude(value, negative);
+        std::size_t digits = detail::count_digits(mag);
+        std::size_t body = digits + (negative ? 1 : 0);
+        std::size_t total = width > body ? width : body;
+        if (total > available()) {
+            return false;
+        }
+        std::size_t size = get_size();
+        char* out = m_data + size;
+        std::size_t padding = total - body;
+        if (fill == '0') {
+            // The zeros are just more digits of the magnitude
+            if (negative) *out++ = '-';
+            detail::write_digits(out, mag, padding + digits);
+        } else {
+            for (std::size_t i = 0; i < padding; ++i) {
+                *out++ = fill;
+            }
+            if (negative) *out++ = '-';
+            detail::write_digits(out, mag, digits);
+        }
+        set_size(size + total);
+        return true;
+    }
+
+    template <typename T>
+    constexpr bool write_hex(T value, std::size_t width, bool uppercase) {
+        using U = std::make_unsigned_t<T>;
+        std::uint64_t bits = static_cast<std::uint64_t>(static_cast<U>(value));
+        std::size_t digits = detail::count_hex_digits(bits);
+        std::size_t total = width > digits ? width : digits;
+        if (total > available()) {
+            return false;
+        }
+        std::size_t size = get_size();
+        detail::write_hex_digits(m_data + size, bits, total, uppercase);
+        set_size(size + total);
+        return true;
+    }
+
+    // pad<Width>(x): a non-negative value below 10^Width is written as
+    // exactly Width digits by the unrolled pair kernel, with no digit count
+    template <std::size_t Width, typename T>
+    constexpr bool write_fixed_width(T value) {
+        static_assert(Width > 0 && Width <= 19, "pad<Width> supports widths 1 to 19");
+        constexpr std::uint64_t limit = [] {
+            std::uint64_t p = 1;
+            for (std::size_t i = 0; i < Width; ++i) p *= 10;
+            return p;
+        }();
+        bool negative = false;
+        std::uint64_t mag = magnitude(value, negative);
+        if (negative || mag >= limit) {
+            return write_padded(value, Width, '0');
+        }
+        if (Width > available()) {
+            return false;
+        }
+        std::size_t size = get_size();
+        detail::write_digits(m_data + size, mag, Width);
+        set_size(size + Width);
+        return true;
+    }
+
+    template <typename... Args>
+    constexpr StackString& append_to_chars(Args... args) {
+        if (!write_to_chars(args...)) set_truncated(true);
+        return *this;
+    }
+};
+
+namespace detail {
+
+template <typename T>
+struct is_stack_string : std::false_type {};
+
+template <std::size_t N, Options Opts>
+struct is_stack_string<StackString<N, Opts>> : std::true_type {};
+
+// How an operand of operator+ becomes a piece. Next to a StackString it may
+// be text (a StackString, C string, literal or string_view), a char or an
+// integer; next to a ConcatExpr any type convertible to std::string_view,
+// such as std::string, is also accepted.
+template <typename T, typename = void>
+struct concat_piece {
+    static constexpr bool basic = false;
+    static constexpr bool any = false;
+};
+
+template <typename T>
+struct concat_piece<T, std::enable_if_t<std::is_convertible_v<const T&, std::string_view> &&
+                                        !std::is_arithmetic_v<T>>> {
+    static constexpr bool basic = is_stack_string<T>::value || std::is_array_v<T> ||
+                                  is_c_string_v<T> || std::is_same_v<T, std::string_view>;
+    static constexpr bool any = true;
+
+    // Arrays and StackStrings have a bounded length
+    static constexpr std::size_t max_size() noexcept {
+        if constexpr (std::is_array_v<T>) {
+            return std::extent_v<T>;
+        } else if constexpr (is_stack_string<T>::value) {
+            return T::capacity > 0 ? T::capacity - 1 : 0;
+        } else {
+            return concat_unbounded;
+        }
+    }
+
+    static constexpr ConcatText<max_size()> make(const T& text) noexcept {
+        if constexpr (std::is_array_v<T>) {
+            return {text, array_string_length(text)};
+        } else {
+            std::string_view sv = text;
+            return {sv.data(), sv.size()};
+        }
+    }
+};
+
+template <>
+struct concat_piece<char> {
+    static constexpr bool basic = true;
+    static constexpr bool any = true;
+
+    static constexpr ConcatChar make(char c) noexcept {
+        return {c};
+    }
+};
+
+template <typename T>
+struct concat_piece<T, std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool> &&
+                                        !std::is_same_v<T, char>>> {
+    static constexpr bool basic = true;
+    static constexpr bool any = true;
+
+    static constexpr ConcatInteger<T> make(T value) noexcept {
+        return ConcatInteger<T>(value);
+    }
+};
+
+template <typename L, typename R>
+struct concat_piece<ConcatExpr<L, R>> {
+    static constexpr bool basic = true;
+    static constexpr bool any = true;
+
+    static constexpr const ConcatExpr<L, R>& make(const ConcatExpr<L, R>& expr) noexcept {
+        return expr;
+    }
+};
+
+// One operand must be a StackString or a ConcatExpr, so operator+ never
+// applies to plain strings, pointers or numbers
+template <typename L, typename R>
+constexpr bool enable_concat_v =
+    ((is_concat_expr<L>::value || is_concat_expr<R>::value) && concat_piece<L>::any && concat_piece<R>::any) ||
+    ((is_stack_string<L>::value || is_stack_string<R>::value) && concat_piece<L>::basic && concat_piece<R>::basic);
+
+template <typename T>
+using concat_piece_t = std::decay_t<decltype(concat_piece<T>::make(std::declval<const T&>()))>;
+
+} // namespace detail
+
+/**
+ * Concatenate lazily: a + ":" + b + ":" + 42 builds a ConcatExpr that a
+ * StackString is constructed from, appended or assigned (via +=) in one pass.
+ * At least one of the first two operands must be a StackString.
+ */
+template <typename L, typename R, typename = std::enable_if_t<detail::enable_concat_v<L, R>>>
+constexpr detail::ConcatExpr<detail::concat_piece_t<L>, detail::concat_piece_t<R>>
+operator+(const L& lhs, const R& rhs) noexcept {
+    return {detail::concat_piece<L>::make(lhs), detail::concat_piece<R>::make(rhs)};
+}
+
+/**
+ * Comparison across capacities and layouts. Equality checks the sizes and
+ * then compares the bytes a block at a time, reading the inline buffers of
+ * both (they are at least min(N, M) + 1 bytes). Ordering is lexicographic
+ * by unsigned byte, as for std::string_view, with a single memcmp; under
+ * C++20 it is a three-way operator<=>. Without these, a < b would compare
+ * the const char* conversions.
+ */
+template <std::size_t N, Options A, std::size_t M, Options B>
+constexpr bool operator==(const StackString<N, A>& a, const StackString<M, B>& b) noexcept {
+    return a.size() == b.size() && detail::equal_chars(a.data(), b.data(), a.size(), (N < M ? N : M) + 1);
+}
+
+template <std::size_t N, Options A, std::size_t M, Options B>
+constexpr bool operator!=(const StackString<N, A>& a, const StackString<M, B>& b) noexcept {
+    return !(a == b);
+}
+
+namespace detail {
+
+// Text compared with a StackString: anything convertible to string_view.
+// Taken as a deduced T so that string literals match exactly and do not
+// tie with the built-in comparison of the const char* conversion.
+template <typename T>
+constexpr bool is_comparable_text_v = std::is_convertible_v<const T&, std::string_view> && !is_stack_string<T>::value;
+
+} // namespace detail
+
+#if defined(__cpp_impl_three_way_comparison) && defined(__cpp_lib_three_way_comparison)
+
+template <std::size_t N, Options A, std::size_t M, Options B>
+constexpr std::strong_ordering operator<=>(const StackString<N, A>& a, const StackString<M, B>& b) noexcept {
+    return a.compare(b) <=> 0;
+}
+
+template <std::size_t N, Options A, typename T, typename = std::enable_if_t<detail::is_comparable_text_v<T>>>
+constexpr std::strong_ordering operator<=>(const StackString<N, A>& a, const T& b) noexcept {
+    return a.compare(b) <=> 0;
+}
+
+#else
+
+template <std::size_t N, Options A, std::size_t M, Options B>
+constexpr bool operator<(const StackString<N, A>& a, const StackString<M, B>& b) noexcept {
+    return a.compare(b) < 0;
+}
+
+template <std::size_t N, Options A, std::size_t M, Options B>
+constexpr bool operator>(const StackString<N, A>& a, const StackString<M, B>& b) noexcept {
+    return a.compare(b) > 0;
+}
+
+template <std::size_t N, Options A, std::size_t M, Options B>
+constexpr bool operator<=(const StackString<N, A>& a, const StackString<M, B>& b) noexcept {
+    return a.compare(b) <= 0;
+}
+
+template <std::size_t N, Options A, std::size_t M, Options B>
+constexpr bool operator>=(const StackString<N, A>& a, const StackString<M, B>& b) noexcept {
+    return a.compare(b) >= 0;
+}
+
+// Text on the left; C++20 rewrites these from the member operators
+template <std::size_t N, Options A, typename T, typename = std::enable_if_t<detail::is_comparable_text_v<T>>>
+constexpr bool operator==(const T& a, const StackString<N, A>& b) noexcept {
+    return b == std::string_view(a);
+}
+
+template <std::size_t N, Options A, typename T, typename = std::enable_if_t<detail::is_comparable_text_v<T>>>
+constexpr bool operator!=(const T& a, const StackString<N, A>& b) noexcept {
+    return b != std::string_view(a);
+}
+
+// Ordering against text on either side
+template <std::size_t N, Options A, typename T, typename = std::enable_if_t<detail::is_comparable_text_v<T>>>
+constexpr bool operator<(const StackString<N, A>& a, const T& b) noexcept {
+    return a.compare(b) < 0;
+}
+
+template <std::size_t N, Options A, typename T, typename = std::enable_if_t<detail::is_comparable_text_v<T>>>
+constexpr bool operator>(const StackString<N, A>& a, const T& b) noexcept {
+    return a.compare(b) > 0;
+}
+
+template <std::size_t N, Options A, typename T, typename = std::enable_if_t<detail::is_comparable_text_v<T>>>
+constexpr bool operator<=(const StackString<N, A>& a, const T& b) noexcept {
+    return a.compare(b) <= 0;
+}
+
+template <std::size_t N, Options A, typename T, typename = std::enable_if_t<detail::is_comparable_text_v<T>>>
+constexpr bool operator>=(const StackString<N, A>& a, const T& b) noexcept {
+    return a.compare(b) >= 0;
+}
+
+template <std::size_t N, Options A, typename T, typename = std::enable_if_t<detail::is_comparable_text_v<T>>>
+constexpr bool operator<(const T& a, const StackString<N, A>& b) noexcept {
+    return b.compare(a) > 0;
+}
+
+template <std::size_t N, Options A, typename T, typename = std::enable_if_t<detail::is_comparable_text_v<T>>>
+constexpr bool operator>(const T& a, const StackString<N, A>& b) noexcept {
+    return b.compare(a) < 0;
+}
+
+template <std::size_t N, Options A, typename T, typename = std::enable_if_t<detail::is_comparable_text_v<T>>>
+constexpr bool operator<=(const T& a, const StackString<N, A>& b) noexcept {
+    return b.compare(a) >= 0;
+}
+
+template <std::size_t N, Options A, typename T, typename = std::enable_if_t<detail::is_comparable_text_v<T>>>
+constexpr bool operator>=(const T& a, const StackString<N, A>& b) noexcept {
+    return b.compare(a) <= 0;
+}
+
+#endif
+
+/**
+ * Hash the contents of a StackString. Whole words are read from the inline
+ * buffer and the bytes past size() are masked, so the result equals
+ * hash(std::string_view) of the same contents for any capacity or layout.
+ */
+template <std::size_t N, Options Opts>
+inline std::size_t hash(const StackString<N, Opts>& s, std::uint64_t seed = 0) noexcept {
+    return static_cast<std::size_t>(detail::hash_bytes(s.data(), s.size(), N + 1, seed));
+}
+
+/**
+ * Transparent hasher for heterogeneous lookup: StackStrings of any capacity,
+ * std::string_view and C strings with equal contents hash equally.
+ */
+struct string_hash {
+    using is_transparent = void;
+
+    std::size_t operator()(std::string_view sv) const noexcept {
+        return hash(sv);
+    }
+
+    template <std::size_t N, Options Opts>
+    std::size_t operator()(const StackString<N, Opts>& s) const noexcept {
+        return hash(s);
+    }
 };
 
 } // namespace stack_string
+
+namespace std {
+
+template <size_t N, stack_string::Options Opts>
+struct hash<stack_string::StackString<N, Opts>> {
+    size_t operator()(const stack_string::StackString<N, Opts>& s) const noexcept {
+        return stack_string::hash(s);
+    }
+};
+
+} // namespace std
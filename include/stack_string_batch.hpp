@@ -0,0 +1,168 @@
+#pragma once
+
+#include "stack_string.hpp"
+
+#include <cerrno>
+#include <climits>
+#include <cstddef>
+#include <string_view>
+#include <system_error>
+
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace stack_string {
+
+/**
+ * A gather list for one writev() or sendmsg(): up to MaxSegments iovecs
+ * pointing straight at the characters of StackStrings, BufferStrings or any
+ * string_view, so several strings go out in one system call without being
+ * concatenated first. Fixed capacity, no allocation. The batch holds
+ * pointers only; the strings must outlive it (or at least the write).
+ *
+ *   string_batch<16> batch;
+ *   batch.add(header);
+ *   batch.add(body.view());
+ *   write_all(fd, batch);
+ *
+ * POSIX only (sys/uio.h).
+ */
+template <std::size_t MaxSegments = 64>
+class string_batch {
+    static_assert(MaxSegments > 0, "string_batch needs at least one segment");
+
+public:
+    static constexpr std::size_t max_segments = MaxSegments;
+
+    /**
+     * Append a segment; text that continues the previous segment in memory
+     * extends it instead. Empty text is skipped.
+     * @return false (and nothing added) if all segments are in use
+     */
+    bool add(std::string_view text) noexcept {
+        if (text.empty()) {
+            return true;
+        }
+        if (m_count > 0) {
+            iovec& last = m_iov[m_count - 1];
+            if (static_cast<const char*>(last.iov_base) + last.iov_len == text.data()) {
+                last.iov_len += text.size();
+                m_bytes += text.size();
+                return true;
+            }
+        }
+        if (m_count == MaxSegments) {
+            return false;
+        }
+        m_iov[m_count++] = iovec{const_cast<char*>(text.data()), text.size()};
+        m_bytes += text.size();
+        return true;
+    }
+
+    // The used bytes of the inline buffer; data() is stable while s lives
+    template <std::size_t N, Options Opts>
+    bool add(const StackString<N, Opts>& s) noexcept {
+        return add(std::string_view(s.data(), s.size()));
+    }
+
+    // Add every argument; false if any did not fit (the earlier ones stay)
+    template <typename... Texts>
+    bool add_all(const Texts&... texts) noexcept {
+        return (add(texts) && ...);
+    }
+
+    void clear() noexcept {
+        m_count = 0;
+        m_bytes = 0;
+    }
+
+    // Segments for writev(), sendmsg() or an io_uring submission
+    const iovec* data() const noexcept {
+        return m_iov;
+    }
+
+    std::size_t size() const noexcept {
+        return m_count;
+    }
+
+    bool empty() const noexcept {
+        return m_count == 0;
+    }
+
+    bool full() const noexcept {
+        return m_count == MaxSegments;
+    }
+
+    // Total bytes across all segments
+    std::size_t bytes() const noexcept {
+        return m_bytes;
+    }
+
+    // A msghdr for sendmsg() on a connected socket
+    msghdr message() const noexcept {
+        msghdr msg{};
+        msg.msg_iov = const_cast<iovec*>(m_iov);
+        msg.msg_iovlen = static_cast<decltype(msg.msg_iovlen)>(m_count);
+        return msg;
+    }
+
+private:
+    template <std::size_t M>
+    friend std::errc write_all(int fd, string_batch<M>& batch) noexcept;
+
+    iovec m_iov[MaxSegments];
+    std::size_t m_count = 0;
+    std::size_t m_bytes = 0;
+};
+
+/**
+ * Write iov[0, count) to fd in full, retrying short writes and EINTR. The
+ * iovecs are advanced in place as bytes go out, so they are not reusable.
+ * Writes at most IOV_MAX segments per call.
+ * @return std::errc() on success, otherwise the errno of the failed writev()
+ */
+inline std::errc write_all(int fd, iovec* iov, std::size_t count) noexcept {
+#if defined(IOV_MAX)
+    constexpr std::size_t max_iov = IOV_MAX;
+#else
+    constexpr std::size_t max_iov = 1024;
+#endif
+    while (count > 0) {
+        if (iov->iov_len == 0) {
+            ++iov;
+            --count;
+            continue;
+        }
+        int n = static_cast<int>(count < max_iov ? count : max_iov);
+        ssize_t written = ::writev(fd, iov, n);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return static_cast<std::errc>(errno);
+        }
+        std::size_t left = static_cast<std::size_t>(written);
+        while (count > 0 && left >= iov->iov_len) {
+            left -= iov->iov_len;
+            ++iov;
+            --count;
+        }
+        if (left > 0) {
+            iov->iov_base = static_cast<char*>(iov->iov_base) + left;
+            iov->iov_len -= left;
+        }
+    }
+    return std::errc();
+}
+
+/**
+ * Write the whole batch to fd (usually in one writev()) and clear it. On
+ * error the batch is cleared too, since an unknown prefix has been written.
+ */
+template <std::size_t MaxSegments>
+std::errc write_all(int fd, string_batch<MaxSegments>& batch) noexcept {
+    std::errc ec = write_all(fd, batch.m_iov, batch.m_count);
+    batch.clear();
+    return ec;
+}
+
+} // namespace stack_string
@@ -0,0 +1,457 @@
+#pragma once
+
+#include "stack_string.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <string_view>
+#include <utility>
+
+namespace stack_string {
+
+namespace detail {
+
+// Bytes allocated past the last row, so a block load starting in any row
+// stays inside the allocation
+constexpr std::size_t column_padding = 64;
+
+/**
+ * True if a[0, n) == b[0, n), a SIMD block at a time. Both sides may be
+ * read up to the next block boundary past n; lanes past n are masked off.
+ */
+inline bool column_bytes_equal(const char* a, const char* b, std::size_t n) noexcept {
+#if defined(STACK_STRING_HAS_SIMD)
+    std::size_t i = 0;
+    for (; i + simd::width <= n; i += simd::width) {
+        if (~simd::eq(simd::load(a + i), simd::load(b + i)) & simd::lanes_below(simd::width)) {
+            return false;
+        }
+    }
+    return i >= n || !(~simd::eq(simd::load(a + i), simd::load(b + i)) & simd::lanes_below(n - i));
+#else
+    return std::memcmp(a, b, n) == 0;
+#endif
+}
+
+} // namespace detail
+
+/**
+ * Many strings of up to N characters stored column-wise: one contiguous
+ * block of N-byte rows (unused bytes zeroed) and a separate array of
+ * lengths. Scans read only the lengths and the rows' bytes, with no
+ * per-element size member in between, and compare a row in one or two
+ * SIMD blocks:
+ *
+ *   column<16> symbols;
+ *   symbols.push_back("AAPL");
+ *   std::vector<std::uint32_t> hits(symbols.size());
+ *   hits.resize(symbols.select_equal("AAPL", hits.data()));
+ *
+ * Results come out as a selection vector (ascending row indices), a
+ * bitmap of (size() + 63) / 64 words (bit i % 64 of word i / 64 for row i)
+ * or a count. Rows are tested 64 at a time into a word of match bits with
+ * no branch per row; selections then visit only the set bits.
+ *
+ * Unlike StackString<N>, a row has no terminator, so all N bytes hold
+ * characters. Strings longer than N are rejected, not truncated.
+ * As in flat_map, an allocator that returns nullptr (such as
+ * ArenaAllocator) makes reserve() and push_back() return false; one that
+ * throws (such as std::allocator) throws through them, leaving the column
+ * unchanged. Copies throw std::bad_alloc either way, and allocators
+ * propagate as their traits say.
+ *
+ * @tparam N Characters per row
+ * @tparam Allocator Allocator for char
+ */
+template <std::size_t N, typename Allocator = std::allocator<char>>
+class column {
+    static_assert(N > 0, "column rows need at least one character");
+
+public:
+    using length_type = detail::size_type_for<N>;
+    using size_type = std::size_t;
+    using allocator_type = Allocator;
+
+    static constexpr std::size_t row_size = N;
+
+private:
+    using char_traits_alloc = std::allocator_traits<Allocator>;
+    using length_alloc = typename char_traits_alloc::template rebind_alloc<length_type>;
+    using length_traits = std::allocator_traits<length_alloc>;
+
+public:
+    column() = default;
+
+    explicit column(const Allocator& alloc) : m_alloc(alloc), m_length_alloc(alloc) {}
+
+    column(const column& other)
+        : column(other, char_traits_alloc::select_on_container_copy_construction(other.m_alloc)) {}
+
+    // Throws std::bad_alloc if the rows cannot be allocated
+    column(const column& other, const Allocator& alloc) : m_alloc(alloc), m_length_alloc(alloc) {
+        if (!reserve(other.m_size)) {
+            throw std::bad_alloc();
+        }
+        if (other.m_size) {
+            std::memcpy(m_chars, other.m_chars, other.m_size * N);
+            std::memcpy(m_lengths, other.m_lengths, other.m_size * sizeof(length_type));
+            m_size = other.m_size;
+        }
+    }
+
+    column(column&& other) noexcept
+        : m_chars(other.m_chars),
+          m_lengths(other.m_lengths),
+          m_size(other.m_size),
+          m_capacity(other.m_capacity),
+          m_alloc(std::move(other.m_alloc)),
+          m_length_alloc(std::move(other.m_length_alloc)) {
+        other.release();
+    }
+
+    // Builds the copy with the allocator this column ends up with before
+    // freeing the old rows, so a failed copy leaves it unchanged
+    column& operator=(const column& other) {
+        if (this != &other) {
+            constexpr bool propagate = char_traits_alloc::propagate_on_container_copy_assignment::value;
+            column tmp(other, propagate ? other.m_alloc : m_alloc);
+            destroy();
+            take(tmp);
+            if constexpr (propagate) {
+                m_alloc = tmp.m_alloc;
+                m_length_alloc = tmp.m_length_alloc;
+            }
+        }
+        return *this;
+    }
+
+    // Copies the rows if the allocator stays and differs from other's
+    column& operator=(column&& other) noexcept(char_traits_alloc::propagate_on_container_move_assignment::value ||
+                                               char_traits_alloc::is_always_equal::value) {
+        if (this == &other) {
+            return *this;
+        }
+        if constexpr (!char_traits_alloc::propagate_on_container_move_assignment::value &&
+                      !char_traits_alloc::is_always_equal::value) {
+            if (!(m_alloc == other.m_alloc)) {
+                return *this = static_cast<const column&>(other);
+            }
+        }
+        destroy();
+        take(other);
+        if constexpr (char_traits_alloc::propagate_on_container_move_assignment::value) {
+            m_alloc = std::move(other.m_alloc);
+            m_length_alloc = std::move(other.m_length_alloc);
+        }
+        return *this;
+    }
+
+    ~column() {
+        destroy();
+    }
+
+    void swap(column& other) noexcept {
+        using std::swap;
+        swap(m_chars, other.m_chars);
+        swap(m_lengths, other.m_lengths);
+        swap(m_size, other.m_size);
+        swap(m_capacity, other.m_capacity);
+        if constexpr (char_traits_alloc::propagate_on_container_swap::value) {
+            swap(m_alloc, other.m_alloc);
+            swap(m_length_alloc, other.m_length_alloc);
+        }
+    }
+
+    allocator_type get_allocator() const noexcept {
+        return m_alloc;
+    }
+
+    // Capacity
+    bool empty() const noexcept { return m_size == 0; }
+    size_type size() const noexcept { return m_size; }
+    size_type capacity() const noexcept { return m_capacity; }
+
+    // Room for count rows; false if the allocation failed
+    bool reserve(size_type count) {
+        if (count <= m_capacity) {
+            return true;
+        }
+        char* chars = char_traits_alloc::allocate(m_alloc, count * N + detail::column_padding);
+        if (!chars) {
+            return false;
+        }
+        length_type* lengths;
+        try {
+            lengths = length_traits::allocate(m_length_alloc, count);
+        } catch (...) {
+            char_traits_alloc::deallocate(m_alloc, chars, count * N + detail::column_padding);
+            throw;
+        }
+        if (!lengths) {
+            char_traits_alloc::deallocate(m_alloc, chars, count * N + detail::column_padding);
+            return false;
+        }
+        if (m_size) {
+            std::memcpy(chars, m_chars, m_size * N);
+            std::memcpy(lengths, m_lengths, m_size * sizeof(length_type));
+        }
+        // Rows are zero-filled as they are written; the tail is zeroed once
+        std::memset(chars + m_size * N, 0, (count - m_size) * N + detail::column_padding);
+        size_type size = m_size;
+        destroy();
+        m_chars = chars;
+        m_lengths = lengths;
+        m_size = size;
+        m_capacity = count;
+        return true;
+    }
+
+    // Modifiers
+    /**
+     * Append a row
+     * @return false (and nothing added) if text is longer than N or the
+     *         column could not grow
+     */
+    bool push_back(std::string_view text) {
+        if (text.size() > N) {
+            return false;
+        }
+        if (m_size == m_capacity && !reserve(m_capacity ? 2 * m_capacity : 16)) {
+            return false;
+        }
+        write_row(m_size, text);
+        ++m_size;
+        return true;
+    }
+
+    template <std::size_t M, Options Opts>
+    bool push_back(const StackString<M, Opts>& text) {
+        return push_back(std::string_view(text.data(), text.size()));
+    }
+
+    // Replace row i (< size()); false if text is longer than N
+    bool set(size_type i, std::string_view text) noexcept {
+        if (text.size() > N) {
+            return false;
+        }
+        write_row(i, text);
+        return true;
+    }
+
+    void clear() noexcept {
+        if (m_size) {
+            std::memset(m_chars, 0, m_size * N);
+        }
+        m_size = 0;
+    }
+
+    // Access
+    std::string_view operator[](size_type i) const noexcept {
+        return std::string_view(row(i), m_lengths[i]);
+    }
+
+    // Row i's N bytes, zero past its length
+    const char* row(size_type i) const noexcept {
+        return m_chars + i * N;
+    }
+
+    // All rows, size() * N bytes
+    const char* data() const noexcept {
+        return m_chars;
+    }
+
+    const length_type* lengths() const noexcept {
+        return m_lengths;
+    }
+
+    // Scans
+    /**
+     * Write the indices of rows equal to value to out (room for size()
+     * entries); returns how many
+     */
+    size_type select_equal(std::string_view value, std::uint32_t* out) const noexcept {
+        return select(out, [&](auto&& sink) { scan_equal(value, sink); });
+    }
+
+    /**
+     * Set bit i % 64 of bitmap[i / 64] for each row i equal to value, and
+     * clear the other bits of those words
+     */
+    void mask_equal(std::string_view value, std::uint64_t* bitmap) const noexcept {
+        scan_equal(value, [bitmap](size_type word, std::uint64_t bits) { bitmap[word] = bits; });
+    }
+
+    size_type count_equal(std::string_view value) const noexcept {
+        size_type count = 0;
+        scan_equal(value, [&](size_type, std::uint64_t bits) { count += detail::popcount(bits); });
+        return count;
+    }
+
+    // As select_equal, for rows starting with prefix
+    size_type select_prefix(std::string_view prefix, std::uint32_t* out) const noexcept {
+        return select(out, [&](auto&& sink) { scan_prefix(prefix, sink); });
+    }
+
+    void mask_prefix(std::string_view prefix, std::uint64_t* bitmap) const noexcept {
+        scan_prefix(prefix, [bitmap](size_type word, std::uint64_t bits) { bitmap[word] = bits; });
+    }
+
+    /**
+     * Hash every row into out[0, size()); each value equals hash() of the
+     * same contents as a StackString or std::string_view
+     */
+    void hash_rows(std::uint64_t* out, std::uint64_t seed = 0) const noexcept {
+        for (size_type i = 0; i < m_size; ++i) {
+            out[i] = detail::hash_bytes(row(i), m_lengths[i], N, seed);
+        }
+    }
+
+private:
+    void write_row(size_type i, std::string_view text) noexcept {
+        char* r = m_chars + i * N;
+        std::memcpy(r, text.data(), text.size());
+        std::memset(r + text.size(), 0, N - text.size());
+        m_lengths[i] = static_cast<length_type>(text.size());
+    }
+
+    /*
+     * Scans test 64 rows into one word of match bits without branching and
+     * hand each word to sink(word_index, bits); bits past size() are zero.
+     * length_bits(base, rows) gives the rows whose length qualifies (a word
+     * with none is skipped) and bytes_match(i) tests row i's characters.
+     * Selections then visit only the set bits.
+     */
+    template <typename LengthBits, typename BytesMatch, typename Sink>
+    void scan(LengthBits&& length_bits, BytesMatch&& bytes_match, Sink&& sink) const noexcept {
+        for (size_type base = 0; base < m_size; base += 64) {
+            size_type rows = m_size - base < 64 ? m_size - base : 64;
+            std::uint64_t lengths = length_bits(base, rows);
+            if (!lengths) {
+                sink(base / 64, 0);
+                continue;
+            }
+            std::uint64_t bits = 0;
+            std::size_t j = 0;
+            for (; j + 4 <= rows; j += 4) {
+                std::uint64_t quad = std::uint64_t(bytes_match(base + j)) |
+                                     std::uint64_t(bytes_match(base + j + 1)) << 1 |
+                                     std::uint64_t(bytes_match(base + j + 2)) << 2 |
+                                     std::uint64_t(bytes_match(base + j + 3)) << 3;
+                bits |= quad << j;
+            }
+            for (; j < rows; ++j) {
+                bits |= std::uint64_t(bytes_match(base + j)) << j;
+            }
+            sink(base / 64, bits & lengths);
+        }
+    }
+
+    // Rows [base, base + rows) whose length equals n: a SIMD compare of
+    // a block of one-byte lengths where the backend yields a bit per lane
+    std::uint64_t lengths_equal(size_type base, size_type rows, length_type n) const noexcept {
+        std::uint64_t bits = 0;
+        size_type j = 0;
+#if defined(STACK_STRING_HAS_SIMD)
+        if constexpr (sizeof(length_type) == 1 && detail::simd::lane_bits == 1) {
+            const char* lengths = reinterpret_cast<const char*>(m_lengths + base);
+            for (; j + detail::simd::width <= rows; j += detail::simd::width) {
+                bits |= detail::simd::eq(detail::simd::load(lengths + j), static_cast<char>(n)) << j;
+            }
+        }
+#endif
+        for (; j < rows; ++j) {
+            bits |= std::uint64_t(m_lengths[base + j] == n) << j;
+        }
+        return bits;
+    }
+
+    std::uint64_t lengths_at_least(size_type base, size_type rows, std::size_t n) const noexcept {
+        std::uint64_t bits = 0;
+        for (size_type j = 0; j < rows; ++j) {
+            bits |= std::uint64_t(m_lengths[base + j] >= n) << j;
+        }
+        return bits;
+    }
+
+    // Rows are zero-padded, so equality compares all N bytes (a constant)
+    // against a zero-padded key, plus the length
+    template <typename Sink>
+    void scan_equal(std::string_view value, Sink&& sink) const noexcept {
+        if (value.size() > N) {
+            scan([](size_type, size_type) { return std::uint64_t(0); },
+                 [](size_type) { return false; }, sink);
+            return;
+        }
+        char key[N + detail::column_padding] = {};
+        std::memcpy(key, value.data(), value.size());
+        auto length = static_cast<length_type>(value.size());
+        scan([&](size_type base, size_type rows) { return lengths_equal(base, rows, length); },
+             [&](size_type i) { return detail::column_bytes_equal(row(i), key, N); }, sink);
+    }
+
+    template <typename Sink>
+    void scan_prefix(std::string_view prefix, Sink&& sink) const noexcept {
+        if (prefix.size() > N) {
+            scan([](size_type, size_type) { return std::uint64_t(0); },
+                 [](size_type) { return false; }, sink);
+            return;
+        }
+        char key[N + detail::column_padding] = {};
+        std::memcpy(key, prefix.data(), prefix.size());
+        std::size_t n = prefix.size();
+        scan([&](size_type base, size_type rows) { return lengths_at_least(base, rows, n); },
+             [&](size_type i) { return detail::column_bytes_equal(row(i), key, n); }, sink);
+    }
+
+    template <typename Scan>
+    size_type select(std::uint32_t* out, Scan&& scan_with) const noexcept {
+        size_type count = 0;
+        scan_with([&](size_type word, std::uint64_t bits) {
+            for (; bits; bits &= bits - 1) {
+                out[count++] = static_cast<std::uint32_t>(word * 64 + detail::count_trailing_zeros(bits));
+            }
+        });
+        return count;
+    }
+
+    void destroy() noexcept {
+        if (m_chars) {
+            char_traits_alloc::deallocate(m_alloc, m_chars, m_capacity * N + detail::column_padding);
+            length_traits::deallocate(m_length_alloc, m_lengths, m_capacity);
+        }
+        release();
+    }
+
+    // Adopt other's rows (not its allocator) and leave other empty
+    void take(column& other) noexcept {
+        m_chars = other.m_chars;
+        m_lengths = other.m_lengths;
+        m_size = other.m_size;
+        m_capacity = other.m_capacity;
+        other.release();
+    }
+
+    void release() noexcept {
+        m_chars = nullptr;
+        m_lengths = nullptr;
+        m_size = 0;
+        m_capacity = 0;
+    }
+
+    char* m_chars = nullptr;
+    length_type* m_lengths = nullptr;
+    size_type m_size = 0;
+    size_type m_capacity = 0;
+    Allocator m_alloc;
+    length_alloc m_length_alloc;
+};
+
+template <std::size_t N, typename Allocator>
+void swap(column<N, Allocator>& a, column<N, Allocator>& b) noexcept {
+    a.swap(b);
+}
+
+} // namespace stack_string
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace stack_string {
+namespace detail {
+
+// "00" "01" ... "99": two decimal digits per lookup
+struct DigitPairs {
+    char chars[200];
+
+    constexpr DigitPairs() noexcept : chars() {
+        for (int i = 0; i < 100; ++i) {
+            chars[2 * i] = static_cast<char>('0' + i / 10);
+            chars[2 * i + 1] = static_cast<char>('0' + i % 10);
+        }
+    }
+};
+
+inline constexpr DigitPairs digit_pairs{};
+
+// "00" "01" ... "ff": one byte, two hex digits per lookup
+struct HexPairs {
+    char chars[512];
+
+    constexpr explicit HexPairs(const char* digits) noexcept : chars() {
+        for (int i = 0; i < 256; ++i) {
+            chars[2 * i] = digits[i >> 4];
+            chars[2 * i + 1] = digits[i & 0xf];
+        }
+    }
+};
+
+inline constexpr HexPairs hex_pairs_lower{"0123456789abcdef"};
+inline constexpr HexPairs hex_pairs_upper{"0123456789ABCDEF"};
+
+// Number of decimal digits in v (1 for 0)
+constexpr std::size_t count_digits(std::uint64_t v) noexcept {
+    std::size_t n = 1;
+    for (;;) {
+        if (v < 10) return n;
+        if (v < 100) return n + 1;
+        if (v < 1000) return n + 2;
+        if (v < 10000) return n + 3;
+        v /= 10000;
+        n += 4;
+    }
+}
+
+// Number of hex digits in v (1 for 0)
+constexpr std::size_t count_hex_digits(std::uint64_t v) noexcept {
+    std::size_t n = 1;
+    if (v >> 32) { n += 8; v >>= 32; }
+    if (v >> 16) { n += 4; v >>= 16; }
+    if (v >> 8) { n += 2; v >>= 8; }
+    if (v >> 4) { n += 1; }
+    return n;
+}
+
+/**
+ * Write the low count decimal digits of v to [out, out + count), two per
+ * table lookup from the right; digits past the value's own are '0', so
+ * this also zero-pads. With a constant count the loop unrolls into
+ * straight-line code.
+ */
+constexpr void write_digits(char* out, std::uint64_t v, std::size_t count) noexcept {
+    char* p = out + count;
+    while (count >= 2) {
+        const char* pair = digit_pairs.chars + 2 * (v % 100);
+        p -= 2;
+        p[0] = pair[0];
+        p[1] = pair[1];
+        v /= 100;
+        count -= 2;
+    }
+    if (count) {
+        *--p = static_cast<char>('0' + v % 10);
+    }
+}
+
+// Write the low count hex digits of v to [out, out + count), zero-padded,
+// a byte per lookup
+constexpr void write_hex_digits(char* out, std::uint64_t v, std::size_t count, bool uppercase) noexcept {
+    const char* pairs = uppercase ? hex_pairs_upper.chars : hex_pairs_lower.chars;
+    char* p = out + count;
+    while (count >= 2) {
+        const char* pair = pairs + 2 * (v & 0xff);
+        p -= 2;
+        p[0] = pair[0];
+        p[1] = pair[1];
+        v >>= 8;
+        count -= 2;
+    }
+    if (count) {
+        *--p = pairs[2 * (v & 0xf) + 1];
+    }
+}
+
+/**
+ * std::to_chars for integers, usable in constant expressions: the digits
+ * of value in base (2 to 36, lowercase) at first, returning their end, or
+ * nullptr with nothing written if they don't fit before last.
+ */
+template <typename T>
+constexpr char* integer_to_chars(char* first, char* last, T value, int base = 10) noexcept {
+    using U = std::make_unsigned_t<T>;
+    U mag = static_cast<U>(value);
+    bool negative = false;
+    if constexpr (std::is_signed_v<T>) {
+        if (value < 0) {
+            negative = true;
+            mag = static_cast<U>(U(0) - mag);
+        }
+    }
+    const U radix = static_cast<U>(base);
+    std::size_t digits = 1;
+    if (base == 10) {
+        digits = count_digits(mag);
+    } else {
+        for (U v = mag; v >= radix; v /= radix) ++digits;
+    }
+    if (static_cast<std::size_t>(last - first) < digits + (negative ? 1 : 0)) {
+        return nullptr;
+    }
+    if (negative) *first++ = '-';
+    if (base == 10) {
+        write_digits(first, mag, digits);
+    } else {
+        for (std::size_t i = digits; i-- > 0; mag /= radix) {
+            first[i] = "0123456789abcdefghijklmnopqrstuvwxyz"[mag % radix];
+        }
+    }
+    return first + digits;
+}
+
+} // namespace detail
+} // namespace stack_string
@@ -0,0 +1,674 @@
+#pragma once
+
+#include "stack_string.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+namespace stack_string {
+
+/**
+ * Open-addressing hash map with StackString keys stored inline in one
+ * contiguous slot array (only StackString keys are supported).
+ *
+ * Lookups hash the key once, compare a group of control bytes per probe step
+ * and compare keys a SIMD block at a time over the fixed-size key buffers.
+ * Keys up to the key's max_size() can be looked up as any StackString or a
+ * std::string_view without building a key_type.
+ *
+ * Allocation failure is reported rather than thrown: with an allocator that
+ * returns nullptr (such as FixedBufAllocator) an insertion that needs to grow
+ * the table returns {end(), false}. Copies are the exception, since a
+ * constructor has no result to report with: a copy that cannot allocate
+ * throws std::bad_alloc and leaves the target unchanged. Allocators
+ * propagate on copy, move and swap as their traits say, as in the
+ * standard containers.
+ *
+ * @tparam Key StackString<N, Opts>
+ * @tparam T Mapped type
+ * @tparam Allocator Allocator for value_type
+ */
+template <typename Key, typename T,
+          typename Allocator = std::allocator<std::pair<const Key, T>>>
+class flat_map;
+
+namespace detail {
+
+/*
+ * SwissTable-style control bytes, one per slot: a full slot stores the low
+ * 7 bits of its key's hash (h2), so a lookup compares a whole group of
+ * control bytes against h2 in one step and only compares keys on a match.
+ */
+constexpr std::int8_t ctrl_empty = -128;  // 0b10000000
+constexpr std::int8_t ctrl_deleted = -2;  // 0b11111110
+
+/**
+ * A group of control bytes loaded together. Match masks have one bit (or
+ * one lane of bits on NEON) per slot; lane() and next() walk them.
+ */
+#if defined(STACK_STRING_HAS_SIMD)
+
+class CtrlGroup {
+public:
+    static constexpr std::size_t width = simd::width;
+
+    explicit CtrlGroup(const std::int8_t* ctrl) noexcept
+        : m_block(simd::load(reinterpret_cast<const char*>(ctrl))) {}
+
+    std::uint64_t match(std::int8_t h2) const noexcept {
+        return simd::eq(m_block, static_cast<char>(h2));
+    }
+
+    std::uint64_t match_empty() const noexcept {
+        return simd::eq(m_block, static_cast<char>(ctrl_empty));
+    }
+
+    // Empty or deleted: slots an insertion may take
+    std::uint64_t match_free() const noexcept {
+        return match_empty() | simd::eq(m_block, static_cast<char>(ctrl_deleted));
+    }
+
+    static std::size_t lane(std::uint64_t mask) noexcept {
+        return simd::first_lane(mask);
+    }
+
+    static std::uint64_t next(std::uint64_t mask) noexcept {
+        return simd::clear_first_lane(mask);
+    }
+
+private:
+    simd::block m_block;
+};
+
+#else
+
+// Portable fallback: eight control bytes per 64-bit word
+class CtrlGroup {
+public:
+    static constexpr std::size_t width = 8;
+
+    explicit CtrlGroup(const std::int8_t* ctrl) noexcept
+        : m_word(hash_load64(reinterpret_cast<const char*>(ctrl))) {}
+
+    // May report a false match in a lane above a true one; callers compare keys
+    std::uint64_t match(std::int8_t h2) const noexcept {
+        std::uint64_t x = m_word ^ (lsbs * static_cast<std::uint8_t>(h2));
+        return (x - lsbs) & ~x & msbs;
+    }
+
+    std::uint64_t match_empty() const noexcept {
+        return m_word & ~(m_word << 6) & msbs;
+    }
+
+    std::uint64_t match_free() const noexcept {
+        return m_word & msbs;
+    }
+
+    static std::size_t lane(std::uint64_t mask) noexcept {
+        return count_trailing_zeros(mask) / 8;
+    }
+
+    static std::uint64_t next(std::uint64_t mask) noexcept {
+        return mask & (mask - 1);
+    }
+
+private:
+    static constexpr std::uint64_t lsbs = 0x0101010101010101ULL;
+    static constexpr std::uint64_t msbs = 0x8080808080808080ULL;
+
+    std::uint64_t m_word;
+};
+
+#endif
+
+/**
+ * Forward iterator over the full slots of a flat_map.
+ */
+template <typename Value, bool Const>
+class FlatMapIterator {
+    template <typename, bool>
+    friend class FlatMapIterator;
+    template <typename, typename, typename>
+    friend class stack_string::flat_map;
+
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = std::remove_const_t<Value>;
+    using difference_type = std::ptrdiff_t;
+    using pointer = std::conditional_t<Const, const Value*, Value*>;
+    using reference = std::conditional_t<Const, const Value&, Value&>;
+
+    FlatMapIterator() noexcept = default;
+
+    // iterator converts to const_iterator
+    template <bool C, typename = std::enable_if_t<Const && !C>>
+    FlatMapIterator(const FlatMapIterator<Value, C>& other) noexcept
+        : m_ctrl(other.m_ctrl), m_ctrl_end(other.m_ctrl_end), m_slot(other.m_slot) {}
+
+    reference operator*() const noexcept { return *m_slot; }
+    pointer operator->() const noexcept { return m_slot; }
+
+    FlatMapIterator& operator++() noexcept {
+        ++m_ctrl;
+        ++m_slot;
+        skip_free();
+        return *this;
+    }
+
+    FlatMapIterator operator++(int) noexcept {
+        FlatMapIterator tmp = *this;
+        ++*this;
+        return tmp;
+    }
+
+    friend bool operator==(const FlatMapIterator& a, const FlatMapIterator& b) noexcept {
+        return a.m_slot == b.m_slot;
+    }
+
+    friend bool operator!=(const FlatMapIterator& a, const FlatMapIterator& b) noexcept {
+        return a.m_slot != b.m_slot;
+    }
+
+private:
+    FlatMapIterator(const std::int8_t* ctrl, const std::int8_t* ctrl_end, pointer slot) noexcept
+        : m_ctrl(ctrl), m_ctrl_end(ctrl_end), m_slot(slot) {}
+
+    void skip_free() noexcept {
+        while (m_ctrl != m_ctrl_end && *m_ctrl < 0) {
+            ++m_ctrl;
+            ++m_slot;
+        }
+    }
+
+    const std::int8_t* m_ctrl = nullptr;
+    const std::int8_t* m_ctrl_end = nullptr;
+    pointer m_slot = nullptr;
+};
+
+} // namespace detail
+
+template <std::size_t N, Options Opts, typename T, typename Allocator>
+class flat_map<StackString<N, Opts>, T, Allocator> {
+public:
+    using key_type = StackString<N, Opts>;
+    using mapped_type = T;
+    using value_type = std::pair<const key_type, T>;
+    using size_type = std::size_t;
+    using allocator_type = Allocator;
+    using iterator = detail::FlatMapIterator<value_type, false>;
+    using const_iterator = detail::FlatMapIterator<value_type, true>;
+
+private:
+    using Group = detail::CtrlGroup;
+    using slot_alloc = typename std::allocator_traits<Allocator>::template rebind_alloc<value_type>;
+    using slot_traits = std::allocator_traits<slot_alloc>;
+
+public:
+    flat_map() = default;
+
+    explicit flat_map(const Allocator& alloc) : m_alloc(alloc) {}
+
+    // Room for `count` elements without rehashing (if the allocation succeeds)
+    explicit flat_map(size_type count, const Allocator& alloc = Allocator()) : m_alloc(alloc) {
+        reserve(count);
+    }
+
+    flat_map(const flat_map& other)
+        : m_alloc(slot_traits::select_on_container_copy_construction(other.m_alloc)) {
+        copy_from(other);
+    }
+
+    flat_map(const flat_map& other, const Allocator& alloc) : m_alloc(alloc) {
+        copy_from(other);
+    }
+
+    flat_map(flat_map&& other) noexcept
+        : m_ctrl(other.m_ctrl)
+        , m_slots(other.m_slots)
+        , m_capacity(other.m_capacity)
+        , m_size(other.m_size)
+        , m_growth_left(other.m_growth_left)
+        , m_alloc(std::move(other.m_alloc)) {
+        other.release();
+    }
+
+    // Strong guarantee: the copy is built, with the allocator this map ends
+    // up with, before the old table is freed with the old allocator
+    flat_map& operator=(const flat_map& other) {
+        if (this != &other) {
+            constexpr bool propagate = slot_traits::propagate_on_container_copy_assignment::value;
+            flat_map tmp(other, propagate ? other.m_alloc : m_alloc);
+            destroy();
+            take(tmp);
+            if constexpr (propagate) {
+                m_alloc = tmp.m_alloc;
+            }
+        }
+        return *this;
+    }
+
+    // Takes other's table unless the allocator stays and differs from
+    // other's, which cannot free it; then the elements are moved one by one
+    flat_map& operator=(flat_map&& other) noexcept(slot_traits::propagate_on_container_move_assignment::value ||
+                                                   slot_traits::is_always_equal::value) {
+        if (this == &other) {
+            return *this;
+        }
+        if constexpr (!slot_traits::propagate_on_container_move_assignment::value &&
+                      !slot_traits::is_always_equal::value) {
+            if (!(m_alloc == other.m_alloc)) {
+                flat_map tmp(m_alloc);
+                tmp.copy_from(other);
+                destroy();
+                take(tmp);
+                return *this;
+            }
+        }
+        destroy();
+        take(other);
+        if constexpr (slot_traits::propagate_on_container_move_assignment::value) {
+            m_alloc = std::move(other.m_alloc);
+        }
+        return *this;
+    }
+
+    ~flat_map() {
+        destroy();
+    }
+
+    // Allocators are swapped only if they propagate on swap; otherwise they
+    // must compare equal, as for the standard containers
+    void swap(flat_map& other) noexcept {
+        using std::swap;
+        swap(m_ctrl, other.m_ctrl);
+        swap(m_slots, other.m_slots);
+        swap(m_capacity, other.m_capacity);
+        swap(m_size, other.m_size);
+        swap(m_growth_left, other.m_growth_left);
+        if constexpr (slot_traits::propagate_on_container_swap::value) {
+            swap(m_alloc, other.m_alloc);
+        }
+    }
+
+    allocator_type get_allocator() const noexcept {
+        return allocator_type(m_alloc);
+    }
+
+    // Iterators
+    iterator begin() noexcept { return make_iterator(0, true); }
+    const_iterator begin() const noexcept { return make_const_iterator(0, true); }
+    const_iterator cbegin() const noexcept { return begin(); }
+
+    iterator end() noexcept { return make_iterator(m_capacity, false); }
+    const_iterator end() const noexcept { return make_const_iterator(m_capacity, false); }
+    const_iterator cend() const noexcept { return end(); }
+
+    // Capacity
+    bool empty() const noexcept { return m_size == 0; }
+    size_type size() const noexcept { return m_size; }
+    size_type bucket_count() const noexcept { return m_capacity; }
+
+    float load_factor() const noexcept {
+        return m_capacity ? static_cast<float>(m_size) / static_cast<float>(m_capacity) : 0.0f;
+    }
+
+    // Grow so that `count` elements fit; false if the allocation failed
+    bool reserve(size_type count) {
+        if (count <= m_size + m_growth_left) {
+            return true;
+        }
+        return resize(capacity_for(count));
+    }
+
+    // Lookup. Heterogeneous overloads take any StackString or a string_view.
+    template <std::size_t M, Options O>
+    iterator find(const StackString<M, O>& key) noexcept {
+        return find_impl(key.data(), key.size(), (M < N ? M : N) + 1);
+    }
+
+    template <std::size_t M, Options O>
+    const_iterator find(const StackString<M, O>& key) const noexcept {
+        return const_cast<flat_map*>(this)->find(key);
+    }
+
+    iterator find(std::string_view key) noexcept {
+        return find_impl(key.data(), key.size(), key.size());
+    }
+
+    const_iterator find(std::string_view key) const noexcept {
+        return const_cast<flat_map*>(this)->find(key);
+    }
+
+    template <typename K>
+    bool contains(const K& key) const noexcept {
+        return find(key) != end();
+    }
+
+    template <typename K>
+    size_type count(const K& key) const noexcept {
+        return contains(key) ? 1 : 0;
+    }
+
+    // Modifiers. Each returns {end(), false} if the table could not grow.
+    template <typename... Args>
+    std::pair<iterator, bool> try_emplace(const key_type& key, Args&&... args) {
+        std::size_t hash = stack_string::hash(key);
+        std::size_t index = find_index(key.data(), key.size(), N + 1, hash);
+        if (index != npos) {
+            return {make_iterator(index, false), false};
+        }
+        index = prepare_insert(hash);
+        if (index == npos) {
+            return {end(), false};
+        }
+        slot_traits::construct(m_alloc, m_slots + index, std::piecewise_construct,
+                               std::forward_as_tuple(key),
+                               std::forward_as_tuple(std::forward<Args>(args)...));
+        return {make_iterator(index, false), true};
+    }
+
+    std::pair<iterator, bool> insert(const value_type& value) {
+        return try_emplace(value.first, value.second);
+    }
+
+    std::pair<iterator, bool> insert(value_type&& value) {
+        return try_emplace(value.first, std::move(value.second));
+    }
+
+    template <typename M>
+    std::pair<iterator, bool> insert_or_assign(const key_type& key, M&& obj) {
+        auto result = try_emplace(key, std::forward<M>(obj));
+        if (!result.second && result.first != end()) {
+            result.first->second = std::forward<M>(obj);
+        }
+        return result;
+    }
+
+    // Returns the number of elements removed (0 or 1)
+    template <typename K>
+    size_type erase(const K& key) {
+        iterator it = find(key);
+        if (it == end()) {
+            return 0;
+        }
+        erase(it);
+        return 1;
+    }
+
+    // Returns the iterator following the removed element
+    iterator erase(const_iterator pos) {
+        std::size_t index = static_cast<std::size_t>(pos.m_slot - m_slots);
+        erase_slot(index);
+        return make_iterator(index + 1, true);
+    }
+
+    iterator erase(iterator pos) {
+        return erase(const_iterator(pos));
+    }
+
+    // Destroys all elements and keeps the allocation
+    void clear() noexcept {
+        for (std::size_t i = 0; i < m_capacity; ++i) {
+            if (m_ctrl[i] >= 0) {
+                slot_traits::destroy(m_alloc, m_slots + i);
+            }
+        }
+        if (m_capacity) {
+            std::memset(m_ctrl, detail::ctrl_empty, m_capacity);
+        }
+        m_size = 0;
+        m_growth_left = max_load(m_capacity);
+    }
+
+private:
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+    // At most 7/8 of the slots are full, so every probe meets an empty slot
+    static constexpr std::size_t max_load(std::size_t capacity) noexcept {
+        return capacity - capacity / 8;
+    }
+
+    // Smallest power-of-two multiple of the group width holding count elements
+    static std::size_t capacity_for(std::size_t count) noexcept {
+        std::size_t capacity = Group::width;
+        while (max_load(capacity) < count) {
+            capacity *= 2;
+        }
+        return capacity;
+    }
+
+    // High bits choose the group, the low 7 bits go in the control byte
+    static std::size_t h1(std::size_t hash) noexcept { return hash >> 7; }
+    static std::int8_t h2(std::size_t hash) noexcept { return static_cast<std::int8_t>(hash & 0x7f); }
+
+    iterator make_iterator(std::size_t index, bool skip) noexcept {
+        iterator it(m_ctrl + index, m_ctrl + m_capacity, m_slots + index);
+        if (skip) it.skip_free();
+        return it;
+    }
+
+    const_iterator make_const_iterator(std::size_t index, bool skip) const noexcept {
+        const_iterator it(m_ctrl + index, m_ctrl + m_capacity, m_slots + index);
+        if (skip) it.skip_free();
+        return it;
+    }
+
+    iterator find_impl(const char* data, std::size_t size, std::size_t readable) noexcept {
+        if (size > max_key_size()) {
+            return end();
+        }
+        std::size_t index = find_index(data, size, readable, detail::hash_bytes(data, size, readable, 0));
+        return index == npos ? end() : make_iterator(index, false);
+    }
+
+    static constexpr std::size_t max_key_size() noexcept {
+        return N > 0 ? N - 1 : 0;
+    }
+
+    // Probe groups in triangular order (visits every group of a power-of-two
+    // table) until the key or an empty slot is found
+    std::size_t find_index(const char* data, std::size_t size, std::size_t readable,
+                           std::size_t hash) const noexcept {
+        if (m_capacity == 0) {
+            return npos;
+        }
+        const std::size_t group_mask = m_capacity / Group::width - 1;
+        std::size_t group = h1(hash) & group_mask;
+        for (std::size_t step = 1;; ++step) {
+            const std::size_t base = group * Group::width;
+            Group g(m_ctrl + base);
+            for (std::uint64_t mask = g.match(h2(hash)); mask; mask = Group::next(mask)) {
+                std::size_t index = base + Group::lane(mask);
+                const key_type& key = m_slots[index].first;
+                if (key.size() == size && detail::equal_chars(key.data(), data, size, readable)) {
+                    return index;
+                }
+            }
+            if (g.match_empty()) {
+                return npos;
+            }
+            group = (group + step) & group_mask;
+        }
+    }
+
+    // First free slot on the probe path for hash
+    std::size_t find_free(std::size_t hash) const noexcept {
+        const std::size_t group_mask = m_capacity / Group::width - 1;
+        std::size_t group = h1(hash) & group_mask;
+        for (std::size_t step = 1;; ++step) {
+            const std::size_t base = group * Group::width;
+            std::uint64_t mask = Group(m_ctrl + base).match_free();
+            if (mask) {
+                return base + Group::lane(mask);
+            }
+            group = (group + step) & group_mask;
+        }
+    }
+
+    // Claim a slot for a new key with this hash, growing the table if needed
+    std::size_t prepare_insert(std::size_t hash) {
+        std::size_t index = m_capacity ? find_free(hash) : npos;
+        if (index == npos || (m_growth_left == 0 && m_ctrl[index] == detail::ctrl_empty)) {
+            // Mostly tombstones: rehash in place instead of doubling
+            std::size_t capacity = (m_capacity && m_size < max_load(m_capacity) / 2)
+                                 ? m_capacity : capacity_for(m_size + 1);
+            if (!resize(capacity)) {
+                return npos;
+            }
+            index = find_free(hash);
+        }
+        if (m_ctrl[index] == detail::ctrl_empty) {
+            --m_growth_left;
+        }
+        m_ctrl[index] = h2(hash);
+        ++m_size;
+        return index;
+    }
+
+    // Slots followed by their control bytes, in a single allocation counted
+    // in value_type units
+    static std::size_t allocation_size(std::size_t capacity) noexcept {
+        return capacity + (capacity + sizeof(value_type) - 1) / sizeof(value_type);
+    }
+
+    bool allocate(std::size_t capacity, std::int8_t*& ctrl, value_type*& slots) {
+        slots = slot_traits::allocate(m_alloc, allocation_size(capacity));
+        if (!slots) {
+            return false;
+        }
+        ctrl = reinterpret_cast<std::int8_t*>(slots + capacity);
+        return true;
+    }
+
+    // Move every element into a fresh table of the given capacity
+    bool resize(std::size_t capacity) {
+        std::int8_t* ctrl;
+        value_type* slots;
+        if (!allocate(capacity, ctrl, slots)) {
+            return false;
+        }
+        std::memset(ctrl, detail::ctrl_empty, capacity);
+
+        std::int8_t* old_ctrl = m_ctrl;
+        value_type* old_slots = m_slots;
+        std::size_t old_capacity = m_capacity;
+        m_ctrl = ctrl;
+        m_slots = slots;
+        m_capacity = capacity;
+        m_growth_left = max_load(capacity) - m_size;
+
+        for (std::size_t i = 0; i < old_capacity; ++i) {
+            if (old_ctrl[i] >= 0) {
+                value_type& old = old_slots[i];
+                std::size_t hash = stack_string::hash(old.first);
+                std::size_t index = find_free(hash);
+                m_ctrl[index] = h2(hash);
+                slot_traits::construct(m_alloc, m_slots + index, std::piecewise_construct,
+                                       std::forward_as_tuple(old.first),
+                                       std::forward_as_tuple(std::move(old.second)));
+                slot_traits::destroy(m_alloc, old_slots + i);
+            }
+        }
+        deallocate(old_slots, old_capacity);
+        return true;
+    }
+
+    // A slot becomes empty again if its group still has an empty slot, since
+    // then no probe has ever passed through the group; otherwise a tombstone
+    void erase_slot(std::size_t index) {
+        slot_traits::destroy(m_alloc, m_slots + index);
+        --m_size;
+        const std::size_t base = index - index % Group::width;
+        if (Group(m_ctrl + base).match_empty()) {
+            m_ctrl[index] = detail::ctrl_empty;
+            ++m_growth_left;
+        } else {
+            m_ctrl[index] = detail::ctrl_deleted;
+        }
+    }
+
+    // Same capacity and slot positions as other, so no rehashing. Values
+    // are moved out of a non-const other. Called on an empty map; throws
+    // std::bad_alloc if the table cannot be allocated.
+    template <typename Map>
+    void copy_from(Map& other) {
+        if (other.m_size == 0) {
+            return;
+        }
+        std::int8_t* ctrl;
+        value_type* slots;
+        if (!allocate(other.m_capacity, ctrl, slots)) {
+            throw std::bad_alloc();
+        }
+        m_ctrl = ctrl;
+        m_slots = slots;
+        std::memset(m_ctrl, detail::ctrl_empty, other.m_capacity);
+        m_capacity = other.m_capacity;
+        try {
+            for (std::size_t i = 0; i < m_capacity; ++i) {
+                if (other.m_ctrl[i] >= 0) {
+                    if constexpr (std::is_const_v<Map>) {
+                        slot_traits::construct(m_alloc, m_slots + i, other.m_slots[i]);
+                    } else {
+                        slot_traits::construct(m_alloc, m_slots + i, std::piecewise_construct,
+                                               std::forward_as_tuple(other.m_slots[i].first),
+                                               std::forward_as_tuple(std::move(other.m_slots[i].second)));
+                    }
+                    m_ctrl[i] = other.m_ctrl[i];
+                    ++m_size;
+                }
+            }
+        } catch (...) {
+            destroy();  // The control bytes mark just the elements built so far
+            throw;
+        }
+        std::memcpy(m_ctrl, other.m_ctrl, m_capacity);
+        m_growth_left = other.m_growth_left;
+    }
+
+    // Adopt other's table (not its allocator) and leave other empty
+    void take(flat_map& other) noexcept {
+        m_ctrl = other.m_ctrl;
+        m_slots = other.m_slots;
+        m_capacity = other.m_capacity;
+        m_size = other.m_size;
+        m_growth_left = other.m_growth_left;
+        other.release();
+    }
+
+    void deallocate(value_type* slots, std::size_t capacity) noexcept {
+        if (capacity) {
+            slot_traits::deallocate(m_alloc, slots, allocation_size(capacity));
+        }
+    }
+
+    void destroy() noexcept {
+        clear();
+        deallocate(m_slots, m_capacity);
+        release();
+    }
+
+    void release() noexcept {
+        m_ctrl = nullptr;
+        m_slots = nullptr;
+        m_capacity = 0;
+        m_size = 0;
+        m_growth_left = 0;
+    }
+
+    std::int8_t* m_ctrl = nullptr;
+    value_type* m_slots = nullptr;
+    std::size_t m_capacity = 0;
+    std::size_t m_size = 0;
+    std::size_t m_growth_left = 0;
+    slot_alloc m_alloc;
+};
+
+} // namespace stack_string
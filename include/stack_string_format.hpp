@@ -0,0 +1,436 @@
+#pragma once
+
+#include "stack_string.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace stack_string {
+
+namespace detail {
+
+// Base of the types created by STACK_STRING_FMT
+struct compile_time_string {};
+
+template <typename S>
+constexpr bool is_compile_time_string_v = std::is_base_of_v<compile_time_string, S>;
+
+/**
+ * Parsed replacement field: {:[[fill]align][sign][#][0][width][.precision][type]}
+ */
+struct FormatSpec {
+    char fill = ' ';
+    char align = '\0';      // '<', '>', '^', or '\0' for the argument's default
+    char sign = '-';        // '+', ' ', or '-' (only negative numbers get a sign)
+    bool alternate = false; // '#': 0x / 0X / 0b / 0 prefix for integers
+    bool zero_pad = false;
+    std::size_t width = 0;
+    int precision = -1;
+    char type = '\0';       // d x X o b | f e g a | s c, or '\0' for the default
+};
+
+/**
+ * One piece of a format string: literal text or a replacement field.
+ */
+struct FormatSegment {
+    bool is_arg = false;
+    std::size_t begin = 0;  // literal text offset in the format string
+    std::size_t length = 0; // literal text length
+    std::size_t arg = 0;    // argument index for replacement fields
+    FormatSpec spec{};
+};
+
+struct FormatParseResult {
+    std::size_t segments = 0;
+    std::size_t args = 0;
+    bool valid = true;
+};
+
+constexpr bool is_format_align(char c) noexcept {
+    return c == '<' || c == '>' || c == '^';
+}
+
+constexpr bool is_format_type(char c) noexcept {
+    switch (c) {
+    case 'd': case 'x': case 'X': case 'o': case 'b':
+    case 'f': case 'e': case 'g': case 'a':
+    case 's': case 'c':
+        return true;
+    default:
+        return false;
+    }
+}
+
+constexpr bool is_format_digit(char c) noexcept {
+    return c >= '0' && c <= '9';
+}
+
+/**
+ * Split a format string into segments. With out == nullptr only counts them,
+ * so the same routine sizes the segment array and then fills it.
+ */
+constexpr FormatParseResult parse_format(std::string_view fmt, FormatSegment* out) noexcept {
+    FormatParseResult result;
+    const std::size_t n = fmt.size();
+    std::size_t i = 0;
+    std::size_t literal_begin = 0;
+
+    auto add_literal = [&](std::size_t begin, std::size_t end) {
+        if (end > begin) {
+            if (out) {
+                out[result.segments] = FormatSegment{false, begin, end - begin, 0, FormatSpec{}};
+            }
+            ++result.segments;
+        }
+    };
+
+    while (i < n) {
+        const char c = fmt[i];
+        if (c == '{') {
+            if (i + 1 < n && fmt[i + 1] == '{') {
+                // "{{" emits a single brace
+                add_literal(literal_begin, i + 1);
+                i += 2;
+                literal_begin = i;
+                continue;
+            }
+            add_literal(literal_begin, i);
+            ++i;
+
+            FormatSpec spec;
+            if (i < n && fmt[i] == ':') {
+                ++i;
+                if (i + 1 < n && is_format_align(fmt[i + 1]) && fmt[i] != '{' && fmt[i] != '}') {
+                    spec.fill = fmt[i];
+                    spec.align = fmt[i + 1];
+                    i += 2;
+                } else if (i < n && is_format_align(fmt[i])) {
+                    spec.align = fmt[i];
+                    ++i;
+                }
+                if (i < n && (fmt[i] == '+' || fmt[i] == '-' || fmt[i] == ' ')) {
+                    spec.sign = fmt[i];
+                    ++i;
+                }
+                if (i < n && fmt[i] == '#') {
+                    spec.alternate = true;
+                    ++i;
+                }
+                if (i < n && fmt[i] == '0') {
+                    spec.zero_pad = true;
+                    ++i;
+                }
+                while (i < n && is_format_digit(fmt[i])) {
+                    spec.width = spec.width * 10 + static_cast<std::size_t>(fmt[i] - '0');
+                    ++i;
+                }
+                if (i < n && fmt[i] == '.') {
+                    ++i;
+                    if (i >= n || !is_format_digit(fmt[i])) {
+                        result.valid = false;
+                        return result;
+                    }
+                    spec.precision = 0;
+                    while (i < n && is_format_digit(fmt[i])) {
+                        spec.precision = spec.precision * 10 + (fmt[i] - '0');
+                        ++i;
+                    }
+                }
+                if (i < n && is_format_type(fmt[i])) {
+                    spec.type = fmt[i];
+                    ++i;
+                }
+            }
+            if (i >= n || fmt[i] != '}') {
+                result.valid = false;
+                return result;
+            }
+            ++i;
+
+            if (out) {
+                out[result.segments] = FormatSegment{true, 0, 0, result.args, spec};
+            }
+            ++result.segments;
+            ++result.args;
+            literal_begin = i;
+        } else if (c == '}') {
+            if (i + 1 < n && fmt[i + 1] == '}') {
+                add_literal(literal_begin, i + 1);
+                i += 2;
+                literal_begin = i;
+                continue;
+            }
+            result.valid = false;
+            return result;
+        } else {
+            ++i;
+        }
+    }
+    add_literal(literal_begin, n);
+    return result;
+}
+
+/**
+ * Compile-time parse of the format string carried by Fmt.
+ */
+template <typename Fmt>
+struct ParsedFormat {
+    static constexpr std::string_view fmt = Fmt::value();
+    static constexpr FormatParseResult result = parse_format(fmt, nullptr);
+
+    static constexpr std::array<FormatSegment, result.segments> make_segments() noexcept {
+        std::array<FormatSegment, result.segments> segments{};
+        parse_format(fmt, segments.data());
+        return segments;
+    }
+
+    static constexpr std::array<FormatSegment, result.segments> segments = make_segments();
+};
+
+/**
+ * Pad the field written at [start, size()) to width, shifting it in place.
+ * Left padding goes after the first skip characters (a sign and base
+ * prefix, for zero padding). Padding is cut short when the string runs out
+ * of room, like append().
+ */
+template <std::size_t N, Options Opts>
+void pad_field(StackString<N, Opts>& out, std::size_t start, std::size_t width,
+               char fill, char align, std::size_t skip) {
+    const std::size_t old_size = out.size();
+    const std::size_t len = old_size - start;
+    if (len >= width) {
+        return;
+    }
+    // Right padding lands in the newly filled tail; shift content for the left
+    out.append_fill(width - len, fill);
+    const std::size_t pad = out.size() - old_size;
+    if (pad == 0) {
+        return;
+    }
+
+    const std::size_t left = (align == '<') ? 0 : (align == '^') ? pad / 2 : pad;
+    char* data = out.data();
+    const std::size_t insert_at = start + (skip < len ? skip : len);
+    if (left > 0) {
+        std::memmove(data + insert_at + left, data + insert_at, old_size - insert_at);
+        std::fill(data + insert_at, data + insert_at + left, fill);
+    }
+}
+
+/**
+ * Append the sign and base prefix of a number, all or nothing. If they do
+ * not fit, the string is left as it was (but marked truncated, as an
+ * append() that drops a number is).
+ */
+template <std::size_t N, Options Opts>
+bool append_number_head(StackString<N, Opts>& out, std::string_view head) {
+    if (out.try_append(head)) {
+        return true;
+    }
+    const std::size_t start = out.size();
+    out.append(head);
+    out.resize(start);
+    return false;
+}
+
+template <typename Fmt, std::size_t I, std::size_t N, Options Opts, typename Arg>
+void format_field(StackString<N, Opts>& out, const Arg& arg) {
+    constexpr FormatSpec spec = ParsedFormat<Fmt>::segments[I].spec;
+    using T = std::decay_t<Arg>;
+    constexpr bool is_bool = std::is_same_v<T, bool>;
+    constexpr bool is_integer = std::is_integral_v<T> && !std::is_same_v<T, char> && !is_bool;
+    constexpr bool is_float = std::is_floating_point_v<T>;
+
+    static_assert(is_integer || is_float || (spec.sign == '-' && !spec.alternate),
+                  "sign and '#' apply only to numeric arguments");
+    static_assert(!is_float || !spec.alternate, "'#' applies only to integer arguments");
+
+    const std::size_t start = out.size();
+    std::size_t head = 0;  // Sign and prefix, kept ahead of zero padding
+
+    if constexpr (is_integer) {
+        static_assert(spec.type == '\0' || spec.type == 'd' || spec.type == 'x' ||
+                      spec.type == 'X' || spec.type == 'o' || spec.type == 'b',
+                      "invalid format type for integer argument");
+        static_assert(spec.precision < 0, "precision not allowed for integer argument");
+        constexpr int base = (spec.type == 'x' || spec.type == 'X') ? 16
+                           : (spec.type == 'o') ? 8
+                           : (spec.type == 'b') ? 2
+                           : 10;
+        using U = std::make_unsigned_t<T>;
+        bool negative = false;
+        if constexpr (std::is_signed_v<T>) {
+            negative = arg < 0;
+        }
+        // The magnitude is written without its sign, so that "-0x1f" keeps
+        // the prefix after the sign
+        const U magnitude = negative ? static_cast<U>(U(0) - static_cast<U>(arg)) : static_cast<U>(arg);
+        char text[3];
+        if (negative) {
+            text[head++] = '-';
+        } else if constexpr (spec.sign != '-') {
+            text[head++] = spec.sign;
+        }
+        if constexpr (spec.alternate && base != 10) {
+            if constexpr (base == 8) {
+                if (magnitude != 0) text[head++] = '0';
+            } else {
+                text[head++] = '0';
+                text[head++] = (base == 2) ? 'b' : spec.type;  // 'x' or 'X'
+            }
+        }
+        if (head > 0 && !append_number_head(out, std::string_view(text, head))) {
+            return;
+        }
+        if constexpr (base == 10) {
+            out.append(magnitude);
+        } else {
+            out.append(magnitude, base);
+        }
+        if (out.size() == start + head) {
+            out.resize(start);  // The digits did not fit: drop the whole number
+            return;
+        }
+        if constexpr (spec.type == 'X') {
+            char* data = out.data();
+            for (std::size_t i = start; i < out.size(); ++i) {
+                if (data[i] >= 'a' && data[i] <= 'z') {
+                    data[i] = static_cast<char>(data[i] - 'a' + 'A');
+                }
+            }
+        }
+    } else if constexpr (is_float) {
+        static_assert(spec.type == '\0' || spec.type == 'f' || spec.type == 'e' ||
+                      spec.type == 'g' || spec.type == 'a',
+                      "invalid format type for floating-point argument");
+        constexpr std::chars_format fmt = (spec.type == 'f') ? std::chars_format::fixed
+                                        : (spec.type == 'e') ? std::chars_format::scientific
+                                        : (spec.type == 'a') ? std::chars_format::hex
+                                        : std::chars_format::general;
+        if constexpr (spec.sign != '-') {
+            if (!std::signbit(arg)) {
+                const char sign = spec.sign;
+                if (!append_number_head(out, std::string_view(&sign, 1))) {
+                    return;
+                }
+            }
+        }
+        const std::size_t digits = out.size();
+        if constexpr (spec.type == '\0' && spec.precision < 0) {
+            out.append(arg);
+        } else if constexpr (spec.precision < 0) {
+            out.append(arg, fmt);
+        } else {
+            out.append(arg, fmt, spec.precision);
+        }
+        if (out.size() == digits) {
+            out.resize(start);
+            return;
+        }
+        head = (out.data()[start] == '-' || out.data()[start] == '+' || out.data()[start] == ' ') ? 1 : 0;
+    } else if constexpr (is_bool) {
+        out.append(arg ? std::string_view("true") : std::string_view("false"));
+    } else {
+        static_assert(spec.type == '\0' || spec.type == 's' ||
+                      (spec.type == 'c' && std::is_same_v<T, char>),
+                      "invalid format type for string argument");
+        static_assert(spec.precision < 0 || !std::is_same_v<T, char>, "precision not allowed for char argument");
+        if constexpr (spec.precision >= 0) {
+            // Precision limits the number of characters taken from a string
+            out.append(std::string_view(arg).substr(0, static_cast<std::size_t>(spec.precision)));
+        } else {
+            out.append(arg);
+        }
+    }
+
+    if constexpr (spec.width > 0) {
+        constexpr bool numeric = is_integer || is_float;
+        constexpr bool zero_pad = numeric && spec.zero_pad && spec.align == '\0';
+        constexpr char fill = zero_pad ? '0' : spec.fill;
+        constexpr char align = (spec.align != '\0') ? spec.align : (numeric ? '>' : '<');
+        pad_field(out, start, spec.width, fill, align, zero_pad ? head : 0);
+    }
+}
+
+template <typename Fmt, std::size_t I, std::size_t N, Options Opts, typename Arg>
+void format_arg(StackString<N, Opts>& out, const Arg& arg) {
+    constexpr FormatSpec spec = ParsedFormat<Fmt>::segments[I].spec;
+    if constexpr (std::is_same_v<std::decay_t<Arg>, bool> && spec.type != '\0' && spec.type != 's') {
+        // As std::format: {:d}, {:x} etc. print a bool as 0 or 1
+        static_assert(spec.type != 'c', "invalid format type for bool argument");
+        format_field<Fmt, I>(out, static_cast<unsigned>(arg));
+    } else {
+        format_field<Fmt, I>(out, arg);
+    }
+}
+
+template <typename Fmt, std::size_t I, std::size_t N, Options Opts, typename Tuple>
+void format_segment(StackString<N, Opts>& out, const Tuple& args) {
+    constexpr FormatSegment segment = ParsedFormat<Fmt>::segments[I];
+    if constexpr (segment.is_arg) {
+        format_arg<Fmt, I>(out, std::get<segment.arg>(args));
+    } else {
+        out.append(ParsedFormat<Fmt>::fmt.substr(segment.begin, segment.length));
+    }
+}
+
+template <typename Fmt, std::size_t N, Options Opts, typename Tuple, std::size_t... I>
+void format_segments(StackString<N, Opts>& out, const Tuple& args, std::index_sequence<I...>) {
+    (format_segment<Fmt, I>(out, args), ...);
+}
+
+} // namespace detail
+
+/**
+ * Wrap a string literal so format_to()/format() can parse it at compile time.
+ * C++17 cannot pass a literal as a constant expression, so the literal is
+ * carried in the type of a small tag object instead.
+ */
+#define STACK_STRING_FMT(str)                                                  \
+    [] {                                                                       \
+        struct StackStringFormat : ::stack_string::detail::compile_time_string { \
+            static constexpr ::std::string_view value() { return str; }        \
+        };                                                                     \
+        return StackStringFormat{};                                            \
+    }()
+
+/**
+ * Append formatted arguments to out. The format string is parsed at compile
+ * time and expands into a fixed sequence of append() calls; replacement
+ * fields support {:[[fill]align][sign][#][0][width][.precision][type]} with
+ * d/x/X/o/b for integers, f/e/g/a for floating point and s/c for strings.
+ * bool prints "true"/"false", or 0/1 with an integer type. Output is
+ * truncated exactly as append() truncates.
+ */
+template <typename Fmt, std::size_t N, Options Opts, typename... Args>
+std::enable_if_t<detail::is_compile_time_string_v<Fmt>, StackString<N, Opts>&>
+format_to(StackString<N, Opts>& out, Fmt, const Args&... args) {
+    using Parsed = detail::ParsedFormat<Fmt>;
+    static_assert(Parsed::result.valid, "invalid format string");
+    static_assert(Parsed::result.args == sizeof...(Args),
+                  "number of arguments does not match the format string");
+    detail::format_segments<Fmt>(out, std::forward_as_tuple(args...),
+                                 std::make_index_sequence<Parsed::result.segments>{});
+    return out;
+}
+
+/**
+ * Format into a new StackString<N>:
+ *   auto s = format<64>(STACK_STRING_FMT("{}:{:>8} {:04x}"), a, b, c);
+ */
+template <std::size_t N, Options Opts = Options::None, typename Fmt, typename... Args>
+std::enable_if_t<detail::is_compile_time_string_v<Fmt>, StackString<N, Opts>>
+format(Fmt fmt, const Args&... args) {
+    StackString<N, Opts> out;
+    format_to(out, fmt, args...);
+    return out;
+}
+
+} // namespace stack_string
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+namespace stack_string {
+namespace detail {
+
+// wyhash secrets: odd 64-bit constants with balanced bit counts
+constexpr std::uint64_t hash_secret0 = 0xa0761d6478bd642fULL;
+constexpr std::uint64_t hash_secret1 = 0xe7037ed1a0b428dbULL;
+constexpr std::uint64_t hash_secret2 = 0x8ebc6af09c88c6e3ULL;
+constexpr std::uint64_t hash_secret3 = 0x589965cc75374cc3ULL;
+
+// 64x64 -> 128 multiply, folded by xor of the two halves
+inline std::uint64_t hash_mum(std::uint64_t a, std::uint64_t b) noexcept {
+#if defined(__SIZEOF_INT128__)
+    __extension__ typedef unsigned __int128 uint128;
+    uint128 r = static_cast<uint128>(a) * b;
+    return static_cast<std::uint64_t>(r) ^ static_cast<std::uint64_t>(r >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    std::uint64_t hi;
+    std::uint64_t lo = _umul128(a, b, &hi);
+    return lo ^ hi;
+#else
+    std::uint64_t a_lo = a & 0xffffffffULL, a_hi = a >> 32;
+    std::uint64_t b_lo = b & 0xffffffffULL, b_hi = b >> 32;
+    std::uint64_t lo_lo = a_lo * b_lo, hi_lo = a_hi * b_lo;
+    std::uint64_t lo_hi = a_lo * b_hi, hi_hi = a_hi * b_hi;
+    std::uint64_t cross = (lo_lo >> 32) + (hi_lo & 0xffffffffULL) + lo_hi;
+    std::uint64_t hi = hi_hi + (hi_lo >> 32) + (cross >> 32);
+    std::uint64_t lo = (cross << 32) | (lo_lo & 0xffffffffULL);
+    return lo ^ hi;
+#endif
+}
+
+// Little-endian 8-byte load, so masking the low bytes keeps the first bytes
+inline std::uint64_t hash_load64(const char* p) noexcept {
+    std::uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    v = __builtin_bswap64(v);
+#endif
+    return v;
+}
+
+// Word at offset i holding the bytes [i, len); bytes past len read as zero.
+// When a whole word fits in the readable extent it is loaded and masked,
+// otherwise only the remaining bytes are copied.
+inline std::uint64_t hash_tail_word(const char* data, std::size_t i, std::size_t len,
+                                    std::size_t readable) noexcept {
+    // len never exceeds readable; the second test lets the compiler see it
+    if (i >= len || i >= readable) return 0;
+    std::size_t rem = len - i;
+    if (i + 8 <= readable) {
+        std::uint64_t word = hash_load64(data + i);
+        return rem >= 8 ? word : word & ((std::uint64_t(1) << (rem * 8)) - 1);
+    }
+    // Fewer than 8 readable bytes remain
+    std::size_t n = rem < readable - i ? rem : readable - i;
+    char buf[8] = {};
+    std::memcpy(buf, data + i, n);
+    return hash_load64(buf);
+}
+
+/**
+ * Hash data[0, len) in 16-byte steps of whole words, wyhash style. `readable`
+ * is how many bytes may be loaded from data (the inline capacity for a
+ * StackString); bytes past len are masked to zero, so the result depends
+ * only on the contents and equals the hash of the same std::string_view.
+ */
+inline std::uint64_t hash_bytes(const char* data, std::size_t len, std::size_t readable,
+                                std::uint64_t seed) noexcept {
+    std::uint64_t h = seed ^ hash_mum(seed ^ hash_secret0, static_cast<std::uint64_t>(len) ^ hash_secret1);
+    std::size_t i = 0;
+    for (; i + 16 <= len && i + 16 <= readable; i += 16) {
+        h = hash_mum(hash_load64(data + i) ^ hash_secret1, hash_load64(data + i + 8) ^ h);
+    }
+    if (i < len) {
+        std::uint64_t a = hash_tail_word(data, i, len, readable);
+        std::uint64_t b = hash_tail_word(data, i + 8, len, readable);
+        h = hash_mum(a ^ hash_secret1, b ^ h);
+    }
+    return hash_mum(h ^ hash_secret2, static_cast<std::uint64_t>(len) ^ hash_secret3);
+}
+
+} // namespace detail
+
+/**
+ * Hash a character sequence; StackString overloads in stack_string.hpp give
+ * the same value for the same contents.
+ */
+inline std::size_t hash(std::string_view sv, std::uint64_t seed = 0) noexcept {
+    return static_cast<std::size_t>(detail::hash_bytes(sv.data(), sv.size(), sv.size(), seed));
+}
+
+} // namespace stack_string
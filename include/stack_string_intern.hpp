@@ -0,0 +1,320 @@
+#pragma once
+
+#include "stack_string.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <string_view>
+
+namespace stack_string {
+
+/**
+ * A 32-bit reference to a string in an intern_table. Equal handles from one
+ * table mean equal strings, so comparing them replaces a string compare.
+ * Default-constructed handles are invalid.
+ */
+class intern_handle {
+public:
+    static constexpr std::uint32_t invalid_value = 0xffffffffu;
+
+    constexpr intern_handle() noexcept = default;
+
+    constexpr explicit intern_handle(std::uint32_t value) noexcept
+        : m_value(value) {}
+
+    constexpr std::uint32_t value() const noexcept {
+        return m_value;
+    }
+
+    constexpr bool valid() const noexcept {
+        return m_value != invalid_value;
+    }
+
+    constexpr explicit operator bool() const noexcept {
+        return valid();
+    }
+
+    friend constexpr bool operator==(intern_handle a, intern_handle b) noexcept {
+        return a.m_value == b.m_value;
+    }
+
+    friend constexpr bool operator!=(intern_handle a, intern_handle b) noexcept {
+        return a.m_value != b.m_value;
+    }
+
+    // Insertion order, not string order
+    friend constexpr bool operator<(intern_handle a, intern_handle b) noexcept {
+        return a.m_value < b.m_value;
+    }
+
+private:
+    std::uint32_t m_value = invalid_value;
+};
+
+namespace detail {
+
+// Open-addressing index of an intern_table: each slot packs the high 32
+// bits of the string's hash over its handle, so most mismatches are
+// rejected without touching the string
+struct InternIndex {
+    static constexpr std::uint64_t empty = ~std::uint64_t(0);
+
+    std::size_t mask;
+    std::unique_ptr<std::atomic<std::uint64_t>[]> slots;
+    InternIndex* retired;  // The table this one replaced
+
+    static InternIndex* create(std::size_t capacity, InternIndex* previous) noexcept {
+        InternIndex* index = new (std::nothrow) InternIndex{capacity - 1, nullptr, previous};
+        if (!index) {
+            return nullptr;
+        }
+        index->slots.reset(new (std::nothrow) std::atomic<std::uint64_t>[capacity]);
+        if (!index->slots) {
+            delete index;
+            return nullptr;
+        }
+        for (std::size_t i = 0; i < capacity; ++i) {
+            index->slots[i].store(empty, std::memory_order_relaxed);
+        }
+        return index;
+    }
+
+    // Entry of the string with this hash for which same(handle) holds, or
+    // empty if the probe sequence ends first
+    template <typename Same>
+    std::uint64_t probe(std::uint64_t hash, Same&& same) const noexcept {
+        auto tag = static_cast<std::uint32_t>(hash >> 32);
+        for (std::size_t i = static_cast<std::size_t>(hash) & mask;; i = (i + 1) & mask) {
+            std::uint64_t entry = slots[i].load(std::memory_order_acquire);
+            if (entry == empty ||
+                (static_cast<std::uint32_t>(entry >> 32) == tag && same(static_cast<std::uint32_t>(entry)))) {
+                return entry;
+            }
+        }
+    }
+
+    void place(std::uint64_t hash, std::uint32_t handle) noexcept {
+        std::size_t i = static_cast<std::size_t>(hash) & mask;
+        while (slots[i].load(std::memory_order_relaxed) != empty) {
+            i = (i + 1) & mask;
+        }
+        slots[i].store((hash >> 32 << 32) | handle, std::memory_order_release);
+    }
+};
+
+} // namespace detail
+
+/**
+ * A deduplicating table of strings of up to N - 1 characters. Each distinct
+ * string is stored once as a StackString<N> and named by a 32-bit
+ * intern_handle, so objects can hold 4 bytes instead of a string and
+ * compare keys as integers:
+ *
+ *   intern_table<32> symbols;
+ *   intern_handle h = symbols.intern("AAPL");   // Same handle every time
+ *   std::string_view name = symbols.view(h);
+ *
+ * Strings live in segments that never move: the first holds 1024 strings
+ * and each further one twice as many as the one before, so view() is a
+ * bit scan and two loads. Handles are assigned in insertion order.
+ *
+ * find(), view() and str() are lock-free and safe alongside insertion.
+ * Insertions take a mutex; the batch intern() takes it once for many
+ * strings. When the index grows, the old one is kept until the table is
+ * destroyed so that concurrent readers never see it freed.
+ *
+ * Failures are reported, not thrown: intern() returns an invalid handle for
+ * a string longer than N - 1 characters or when memory runs out.
+ *
+ * @tparam N Capacity of each stored StackString, terminator included
+ */
+template <std::size_t N>
+class intern_table {
+public:
+    using string_type = StackString<N>;
+
+    static constexpr std::size_t first_segment_bits = 10;
+    static constexpr std::size_t segment_count = 32 - first_segment_bits + 1;
+    // The largest handle that fits is invalid_value - 1
+    static constexpr std::size_t max_strings = intern_handle::invalid_value;
+
+    intern_table() noexcept = default;
+
+    intern_table(const intern_table&) = delete;
+    intern_table& operator=(const intern_table&) = delete;
+
+    ~intern_table() {
+        for (std::atomic<string_type*>& segment : m_segments) {
+            delete[] segment.load(std::memory_order_relaxed);
+        }
+        detail::InternIndex* index = m_index.load(std::memory_order_relaxed);
+        while (index) {
+            detail::InternIndex* retired = index->retired;
+            delete index;
+            index = retired;
+        }
+    }
+
+    /**
+     * The handle of text, adding it if it is new
+     * @return an invalid handle if text is too long or memory runs out
+     */
+    intern_handle intern(std::string_view text) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return intern_locked(text);
+    }
+
+    template <std::size_t M, Options Opts>
+    intern_handle intern(const StackString<M, Opts>& text) {
+        return intern(std::string_view(text.data(), text.size()));
+    }
+
+    /**
+     * Intern texts[0, count) under one lock, storing the handles in out.
+     * Texts may be anything convertible to std::string_view.
+     * @return the number interned; stops at the first failure
+     */
+    template <typename Text>
+    std::size_t intern(const Text* texts, std::size_t count, intern_handle* out) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!reserve_locked(size() + count)) {
+            return 0;
+        }
+        for (std::size_t i = 0; i < count; ++i) {
+            out[i] = intern_locked(std::string_view(texts[i]));
+            if (!out[i]) {
+                return i;
+            }
+        }
+        return count;
+    }
+
+    /**
+     * Make room for count strings in total, so interning up to that many
+     * allocates no further index.
+     */
+    bool reserve(std::size_t count) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return reserve_locked(count);
+    }
+
+    /**
+     * The handle of text if it has been interned, otherwise an invalid one.
+     * Lock-free.
+     */
+    intern_handle find(std::string_view text) const noexcept {
+        const detail::InternIndex* index = m_index.load(std::memory_order_acquire);
+        if (!index) {
+            return intern_handle();
+        }
+        std::uint64_t entry = index->probe(hash_of(text), same_as(text));
+        return entry == detail::InternIndex::empty ? intern_handle() : intern_handle(static_cast<std::uint32_t>(entry));
+    }
+
+    template <std::size_t M, Options Opts>
+    intern_handle find(const StackString<M, Opts>& text) const noexcept {
+        return find(std::string_view(text.data(), text.size()));
+    }
+
+    // The string named by h, which must be a valid handle from this table
+    const string_type& str(intern_handle h) const noexcept {
+        std::uint32_t v = h.value();
+        unsigned segment = detail::highest_bit((v >> first_segment_bits) + 1);
+        std::size_t offset = v - ((first_segment_size << segment) - first_segment_size);
+        return m_segments[segment].load(std::memory_order_acquire)[offset];
+    }
+
+    std::string_view view(intern_handle h) const noexcept {
+        const string_type& s = str(h);
+        return std::string_view(s.data(), s.size());
+    }
+
+    // Number of distinct strings
+    std::size_t size() const noexcept {
+        return m_size.load(std::memory_order_acquire);
+    }
+
+    bool empty() const noexcept {
+        return size() == 0;
+    }
+
+private:
+    static constexpr std::size_t first_segment_size = std::size_t(1) << first_segment_bits;
+
+    static std::uint64_t hash_of(std::string_view text) noexcept {
+        return detail::hash_bytes(text.data(), text.size(), text.size(), 0);
+    }
+
+    auto same_as(std::string_view text) const noexcept {
+        return [this, text](std::uint32_t handle) { return view(intern_handle(handle)) == text; };
+    }
+
+    intern_handle intern_locked(std::string_view text) {
+        if (text.size() > N - 1) {
+            return intern_handle();
+        }
+        std::uint64_t hash = hash_of(text);
+        detail::InternIndex* index = m_index.load(std::memory_order_relaxed);
+        if (index) {
+            std::uint64_t entry = index->probe(hash, same_as(text));
+            if (entry != detail::InternIndex::empty) {
+                return intern_handle(static_cast<std::uint32_t>(entry));
+            }
+        }
+
+        std::size_t count = m_size.load(std::memory_order_relaxed);
+        if (count == max_strings || !reserve_locked(count + 1)) {
+            return intern_handle();
+        }
+        auto handle = static_cast<std::uint32_t>(count);
+        unsigned segment = detail::highest_bit((handle >> first_segment_bits) + 1);
+        string_type* strings = m_segments[segment].load(std::memory_order_relaxed);
+        if (!strings) {
+            strings = new (std::nothrow) string_type[first_segment_size << segment];
+            if (!strings) {
+                return intern_handle();
+            }
+            m_segments[segment].store(strings, std::memory_order_release);
+        }
+        // Not yet reachable by readers: the index slot below publishes it
+        strings[handle - ((first_segment_size << segment) - first_segment_size)] = string_type(text);
+        m_index.load(std::memory_order_relaxed)->place(hash, handle);
+        m_size.store(count + 1, std::memory_order_release);
+        return intern_handle(handle);
+    }
+
+    // Keep the index at most half full
+    bool reserve_locked(std::size_t count) {
+        detail::InternIndex* index = m_index.load(std::memory_order_relaxed);
+        std::size_t capacity = index ? index->mask + 1 : 0;
+        if (count * 2 <= capacity) {
+            return true;
+        }
+        std::size_t grown = capacity ? capacity : 2 * first_segment_size;
+        while (grown < count * 2) {
+            grown *= 2;
+        }
+        detail::InternIndex* replacement = detail::InternIndex::create(grown, index);
+        if (!replacement) {
+            return false;
+        }
+        std::size_t strings = m_size.load(std::memory_order_relaxed);
+        for (std::size_t h = 0; h < strings; ++h) {
+            replacement->place(hash_of(view(intern_handle(static_cast<std::uint32_t>(h)))),
+                               static_cast<std::uint32_t>(h));
+        }
+        m_index.store(replacement, std::memory_order_release);
+        return true;
+    }
+
+    std::atomic<string_type*> m_segments[segment_count] = {};
+    std::atomic<detail::InternIndex*> m_index{nullptr};
+    std::atomic<std::size_t> m_size{0};
+    std::mutex m_mutex;  // Serializes insertion
+};
+
+} // namespace stack_string
@@ -0,0 +1,406 @@
+#pragma once
+
+#include "stack_string.hpp"
+#include "stack_string_batch.hpp"
+#include "stack_string_ring.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#define STACK_STRING_LOG_RDTSC 1
+#endif
+
+namespace stack_string {
+
+/**
+ * What async_logger::log() does when the calling thread's queue is full
+ */
+enum class log_overflow {
+    drop,   // Discard the line and count it in dropped()
+    block,  // Yield until the background thread frees a slot
+};
+
+namespace detail {
+
+/**
+ * A cheap, monotonic timestamp for the hot path: the TSC on x86, the
+ * virtual counter on AArch64, steady_clock nanoseconds elsewhere. The
+ * logger converts it to wall-clock time off the hot path.
+ */
+inline std::uint64_t log_ticks() noexcept {
+#if defined(STACK_STRING_LOG_RDTSC)
+    return __rdtsc();
+#elif defined(__aarch64__) && (defined(__GNUC__) || defined(__clang__))
+    std::uint64_t v;
+    __asm__ volatile("mrs %0, cntvct_el0" : "=r"(v));
+    return v;
+#else
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+inline std::int64_t log_wall_ns() noexcept {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+// Shared between a producer thread and one logger, so either can go first
+struct LogProducerBase {
+    std::atomic<bool> thread_exited{false};
+    std::atomic<bool> logger_closed{false};
+
+    virtual ~LogProducerBase() = default;
+};
+
+struct LogThreadEntry {
+    std::uint64_t logger_id;
+    std::shared_ptr<LogProducerBase> producer;
+};
+
+// A thread's queues, one per logger it has written to. At thread exit each
+// is handed back to its logger for reuse by a later thread.
+struct LogThreadEntries {
+    std::vector<LogThreadEntry> entries;
+
+    ~LogThreadEntries() {
+        for (LogThreadEntry& e : entries) {
+            e.producer->thread_exited.store(true, std::memory_order_release);
+        }
+    }
+};
+
+inline LogThreadEntries& log_thread_entries() {
+    thread_local LogThreadEntries entries;
+    return entries;
+}
+
+// Distinguishes loggers, including one constructed where another was
+inline std::uint64_t next_logger_id() noexcept {
+    static std::atomic<std::uint64_t> id{0};
+    return id.fetch_add(1, std::memory_order_relaxed) + 1;
+}
+
+} // namespace detail
+
+/**
+ * An asynchronous line logger. A hot thread formats straight into a slot of
+ * its own spsc ring with operator<< and commits it at the end of the
+ * statement; a background thread gathers committed lines from every
+ * thread's ring, prefixes each with a timestamp and writes them out with
+ * one writev() per batch.
+ *
+ *   async_logger<> log(STDERR_FILENO);
+ *   log.log() << "order " << id << " filled at " << price;
+ *   // "14:03:27.512093 order 42 filled at 101.5\n"
+ *
+ * - **Per-thread queues**: a thread's first log() registers a QueueSize-slot
+ *   ring with the logger; after that a log() is a thread-local lookup, a
+ *   counter read and the formatting itself. Queues of exited threads are
+ *   reused by new ones
+ * - **Timestamps**: taken with rdtsc (or the platform's counter) when the
+ *   line starts, and converted to UTC time of day by the background thread
+ * - **Full queue**: log_overflow::drop discards the line (the returned line
+ *   ignores its input), log_overflow::block waits for a slot
+ * - **Lines**: StackString<LineSize>, so at most LineSize - 1 characters
+ *   including the newline, which is always added; longer text is truncated
+ *
+ * Lines from one thread are written in order; lines from different threads
+ * are interleaved batch by batch, each batch starting at the next thread.
+ * The logger does not own fd. Destruction writes everything committed so
+ * far and joins the background thread; no thread may log() once it has
+ * started.
+ *
+ * @tparam LineSize Capacity of one line
+ * @tparam QueueSize Slots per producer thread, a power of two
+ */
+template <std::size_t LineSize = 256, std::size_t QueueSize = 1024>
+class async_logger {
+    struct record {
+        std::uint64_t ticks = 0;
+        StackString<LineSize> text;
+
+        void clear() noexcept {
+            text.clear();
+        }
+    };
+
+    using queue_type = ring<record, QueueSize>;
+
+    struct producer : detail::LogProducerBase {
+        queue_type queue;
+    };
+
+public:
+    using text_type = StackString<LineSize>;
+
+    // Lines per writev(); each takes two segments, the stamp and the text
+    static constexpr std::size_t batch_lines = 64;
+    // Background thread's sleep when every queue is empty
+    static constexpr std::chrono::microseconds idle_wait{100};
+
+    /**
+     * A line being formatted; committed when it goes out of scope, normally
+     * at the end of the log() statement. Empty, and ignoring everything
+     * streamed into it, if the line was dropped.
+     */
+    class line {
+    public:
+        line(line&& other) noexcept
+            : m_queue(other.m_queue), m_slot(std::exchange(other.m_slot, typename queue_type::reservation())) {}
+
+        line& operator=(line&&) = delete;
+
+        ~line() {
+            if (m_slot) {
+                text_type& text = m_slot->text;
+                if (text.size() == text.max_size()) {
+                    text[text.size() - 1] = '\n';
+                } else {
+                    text.append('\n');
+                }
+                m_queue->commit(m_slot);
+            }
+        }
+
+        template <typename T>
+        line& operator<<(T&& value) {
+            if (m_slot) {
+                m_slot->text << std::forward<T>(value);
+            }
+            return *this;
+        }
+
+        // False if the line was dropped
+        explicit operator bool() const noexcept {
+            return static_cast<bool>(m_slot);
+        }
+
+        // The text so far, for the append_* members; nullptr if dropped
+        text_type* text() const noexcept {
+            return m_slot ? &m_slot->text : nullptr;
+        }
+
+    private:
+        friend class async_logger;
+
+        line(queue_type* queue, typename queue_type::reservation slot) noexcept
+            : m_queue(queue), m_slot(slot) {}
+
+        queue_type* m_queue;
+        typename queue_type::reservation m_slot;
+    };
+
+    explicit async_logger(int fd, log_overflow overflow = log_overflow::drop)
+        : m_fd(fd),
+          m_overflow(overflow),
+          m_id(detail::next_logger_id()),
+          m_origin_ticks(detail::log_ticks()),
+          m_origin_ns(detail::log_wall_ns()),
+          m_thread([this] { run(); }) {}
+
+    async_logger(const async_logger&) = delete;
+    async_logger& operator=(const async_logger&) = delete;
+
+    ~async_logger() {
+        m_stop.store(true, std::memory_order_release);
+        m_thread.join();
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (const std::shared_ptr<producer>& p : m_producers) {
+            p->logger_closed.store(true, std::memory_order_release);
+        }
+    }
+
+    /**
+     * Start a line in the calling thread's queue, timestamped now
+     */
+    line log() {
+        producer* p = local_producer();
+        typename queue_type::reservation slot = p->queue.reserve();
+        if (!slot && m_overflow == log_overflow::block) {
+            do {
+                std::this_thread::yield();
+                slot = p->queue.reserve();
+            } while (!slot);
+        }
+        if (slot) {
+            slot->ticks = detail::log_ticks();
+        } else {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+        return line(&p->queue, slot);
+    }
+
+    /**
+     * Wait until every line committed so far has been written
+     */
+    void flush() {
+        for (;;) {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (std::all_of(m_producers.begin(), m_producers.end(),
+                                [](const std::shared_ptr<producer>& p) { return p->queue.empty(); })) {
+                    return;
+                }
+            }
+            std::this_thread::sleep_for(idle_wait);
+        }
+    }
+
+    // Lines discarded under log_overflow::drop
+    std::size_t dropped() const noexcept {
+        return m_dropped.load(std::memory_order_relaxed);
+    }
+
+    // Batches whose writev() failed; their lines are lost
+    std::size_t write_errors() const noexcept {
+        return m_write_errors.load(std::memory_order_relaxed);
+    }
+
+private:
+    producer* local_producer() {
+        for (const detail::LogThreadEntry& e : detail::log_thread_entries().entries) {
+            if (e.logger_id == m_id) {
+                return static_cast<producer*>(e.producer.get());
+            }
+        }
+        return register_thread();
+    }
+
+    // First log() from this thread: adopt the queue of an exited thread, or
+    // add a new one
+    producer* register_thread() {
+        std::vector<detail::LogThreadEntry>& entries = detail::log_thread_entries().entries;
+        entries.erase(std::remove_if(entries.begin(), entries.end(),
+                                     [](const detail::LogThreadEntry& e) {
+                                         return e.producer->logger_closed.load(std::memory_order_acquire);
+                                     }),
+                      entries.end());
+
+        std::shared_ptr<producer> adopted;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            for (const std::shared_ptr<producer>& p : m_producers) {
+                if (p->thread_exited.load(std::memory_order_acquire) && p->queue.empty()) {
+                    p->thread_exited.store(false, std::memory_order_relaxed);
+                    adopted = p;
+                    break;
+                }
+            }
+            if (!adopted) {
+                adopted = std::make_shared<producer>();
+                m_producers.push_back(adopted);
+                m_generation.fetch_add(1, std::memory_order_release);
+            }
+        }
+        entries.push_back(detail::LogThreadEntry{m_id, adopted});
+        return adopted.get();
+    }
+
+    void run() {
+        std::vector<std::shared_ptr<producer>> producers;
+        std::vector<std::size_t> taken;
+        std::uint64_t generation = 0;
+        string_batch<2 * batch_lines> batch;
+        StackString<24> stamps[batch_lines];
+        std::size_t start = 0;
+
+        for (;;) {
+            // Read before draining: everything committed before the
+            // destructor ran is then visible to this pass
+            bool stopping = m_stop.load(std::memory_order_acquire);
+            if (m_generation.load(std::memory_order_acquire) != generation) {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                producers = m_producers;
+                generation = m_generation.load(std::memory_order_relaxed);
+                taken.assign(producers.size(), 0);
+            }
+
+            std::size_t lines = 0;
+            std::uint64_t now_ticks = detail::log_ticks();
+            std::int64_t now_ns = detail::log_wall_ns();
+            // Each pass starts one producer later, so a thread that always
+            // has a full batch queued cannot starve the ones after it
+            start = start + 1 < producers.size() ? start + 1 : 0;
+            for (std::size_t k = 0; k < producers.size() && lines < batch_lines; ++k) {
+                std::size_t i = start + k < producers.size() ? start + k : start + k - producers.size();
+                queue_type& queue = producers[i]->queue;
+                std::size_t n = 0;
+                while (lines < batch_lines) {
+                    record* r = queue.peek(n);
+                    if (!r) break;
+                    format_stamp(stamps[lines], r->ticks, now_ticks, now_ns);
+                    batch.add(stamps[lines]);
+                    batch.add(r->text);
+                    ++n;
+                    ++lines;
+                }
+                taken[i] = n;
+            }
+
+            if (lines == 0) {
+                if (stopping) return;
+                std::this_thread::sleep_for(idle_wait);
+                continue;
+            }
+            if (write_all(m_fd, batch) != std::errc()) {
+                m_write_errors.fetch_add(1, std::memory_order_relaxed);
+            }
+            for (std::size_t i = 0; i < producers.size(); ++i) {
+                if (taken[i]) {
+                    producers[i]->queue.pop_n(taken[i]);
+                    taken[i] = 0;
+                }
+            }
+        }
+    }
+
+    // "HH:MM:SS.uuuuuu " in UTC. Ticks are scaled by the rate measured
+    // between construction and now, which is at or after the line's ticks.
+    void format_stamp(StackString<24>& out, std::uint64_t ticks, std::uint64_t now_ticks,
+                      std::int64_t now_ns) const {
+        std::int64_t ns = m_origin_ns;
+        std::uint64_t span = now_ticks - m_origin_ticks;
+        if (span != 0) {
+            double ns_per_tick = static_cast<double>(now_ns - m_origin_ns) / static_cast<double>(span);
+            auto elapsed = static_cast<std::int64_t>(ticks - m_origin_ticks);
+            ns += static_cast<std::int64_t>(static_cast<double>(elapsed) * ns_per_tick);
+        }
+        auto us = static_cast<std::uint64_t>(ns / 1000);
+        std::uint64_t seconds = us / 1000000 % 86400;
+        out.clear();
+        out << pad<2>(seconds / 3600) << ':' << pad<2>(seconds / 60 % 60) << ':' << pad<2>(seconds % 60)
+            << '.' << pad<6>(us % 1000000) << ' ';
+    }
+
+    int m_fd;
+    log_overflow m_overflow;
+    std::uint64_t m_id;
+    std::uint64_t m_origin_ticks;
+    std::int64_t m_origin_ns;
+    std::atomic<std::size_t> m_dropped{0};
+    std::atomic<std::size_t> m_write_errors{0};
+    std::atomic<bool> m_stop{false};
+
+    std::mutex m_mutex;  // Guards m_producers
+    std::vector<std::shared_ptr<producer>> m_producers;
+    std::atomic<std::uint64_t> m_generation{0};
+    std::thread m_thread;  // Last, so it starts after everything above
+};
+
+} // namespace stack_string
@@ -0,0 +1,408 @@
+#pragma once
+
+#include "stack_string.hpp"
+#include "stack_string_batch.hpp"
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace stack_string {
+
+/**
+ * On-disk header of a mapped_array file, followed directly by count
+ * elements of element_size bytes each, exactly as they sit in memory.
+ * Fields are in the writer's byte order, recorded in `endian`.
+ */
+struct mapped_array_header {
+    char magic[8];                // "STKSTRA" and a NUL
+    std::uint32_t version;        // mapped_array_version
+    std::uint32_t endian;         // mapped_array_endian as the writer stored it
+    std::uint64_t capacity;       // N of StackString<N, Opts>
+    std::uint32_t options;        // Opts bits
+    std::uint32_t element_size;   // sizeof(StackString<N, Opts>)
+    std::uint64_t element_align;  // alignof(StackString<N, Opts>)
+    std::uint64_t count;          // Number of elements
+    std::uint64_t checksum;       // mapped_array_checksum() of the elements
+    std::uint64_t reserved;       // Zero
+};
+
+static_assert(sizeof(mapped_array_header) == 64, "mapped_array_header must stay 64 bytes");
+
+constexpr char mapped_array_magic[8] = {'S', 'T', 'K', 'S', 'T', 'R', 'A', '\0'};
+constexpr std::uint32_t mapped_array_version = 1;
+constexpr std::uint32_t mapped_array_endian = 0x01020304u;
+
+/**
+ * How much of a file mapped_array::open() checks. The header is always
+ * validated against the element type; contents also verifies the checksum
+ * and that every element's size is in range, so a damaged file cannot
+ * make view() read out of bounds.
+ */
+enum class mapped_check {
+    header,
+    contents,
+};
+
+namespace detail {
+
+// Checksum granularity, so the writer can hash as it streams
+constexpr std::size_t mapped_checksum_block = 64 * 1024;
+
+template <typename T>
+struct is_mappable_string : std::false_type {};
+
+template <std::size_t N, Options Opts>
+struct is_mappable_string<StackString<N, Opts>> : std::bool_constant<std::is_standard_layout_v<StackString<N, Opts>>> {};
+
+} // namespace detail
+
+/**
+ * Checksum of element bytes: hash() of each 64 KiB block in turn, seeded
+ * with the previous block's result. Continue with the returned value as
+ * seed; blocks must be whole except for the last.
+ */
+inline std::uint64_t mapped_array_checksum(const char* data, std::size_t size, std::uint64_t seed = 0) noexcept {
+    for (std::size_t i = 0; i < size; i += detail::mapped_checksum_block) {
+        std::size_t n = size - i < detail::mapped_checksum_block ? size - i : detail::mapped_checksum_block;
+        seed = detail::hash_bytes(data + i, n, n, seed);
+    }
+    return seed;
+}
+
+template <typename T>
+class mapped_array;
+
+/**
+ * A read-only, memory-mapped file of StackString<N, Opts> elements, used
+ * in place: open() maps the file and checks it, after which operator[]
+ * returns references into the mapping. Nothing is parsed or copied. The
+ * default mapped_check::contents still reads the whole file once, to
+ * verify the checksum and every element's size; mapped_check::header
+ * checks only the header, so loading costs the page faults of the data
+ * actually touched, for files from a trusted writer.
+ *
+ *   mapped_array<StackString<32>> names;
+ *   if (names.open("instruments.ssa", mapped_check::header) != std::errc()) { ... }
+ *   std::string_view first = names[0];
+ *
+ * StackString holds no pointers, so its bytes mean the same in any
+ * process. The header records N, the layout options, the element size and
+ * the byte order, and a file is only accepted by the exact type that wrote
+ * it. Files are written by mapped_array_writer. POSIX only.
+ *
+ * @tparam T StackString<N, Opts>
+ */
+template <std::size_t N, Options Opts>
+class mapped_array<StackString<N, Opts>> {
+public:
+    using value_type = StackString<N, Opts>;
+    using const_iterator = const value_type*;
+    using size_type = std::size_t;
+
+    static_assert(detail::is_mappable_string<value_type>::value, "mapped_array needs a standard-layout StackString");
+    static_assert(alignof(value_type) <= sizeof(mapped_array_header), "elements must be aligned by the header size");
+
+    mapped_array() noexcept = default;
+
+    mapped_array(const mapped_array&) = delete;
+    mapped_array& operator=(const mapped_array&) = delete;
+
+    mapped_array(mapped_array&& other) noexcept
+        : m_map(std::exchange(other.m_map, nullptr)), m_length(std::exchange(other.m_length, 0)) {}
+
+    mapped_array& operator=(mapped_array&& other) noexcept {
+        if (this != &other) {
+            close();
+            m_map = std::exchange(other.m_map, nullptr);
+            m_length = std::exchange(other.m_length, 0);
+        }
+        return *this;
+    }
+
+    ~mapped_array() {
+        close();
+    }
+
+    /**
+     * Map path and validate it for this element type
+     * @return std::errc() on success; the errno of a failed open, fstat or
+     *         mmap; invalid_argument for a file of another format, version,
+     *         byte order or element type; bad_message for a truncated or
+     *         damaged one
+     */
+    std::errc open(const char* path, mapped_check check = mapped_check::contents) noexcept {
+        close();
+        int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            return static_cast<std::errc>(errno);
+        }
+        struct stat st;
+        if (::fstat(fd, &st) != 0) {
+            int err = errno;
+            ::close(fd);
+            return static_cast<std::errc>(err);
+        }
+        auto length = static_cast<std::size_t>(st.st_size);
+        if (length < sizeof(mapped_array_header)) {
+            ::close(fd);
+            return std::errc::bad_message;
+        }
+        void* map = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        int err = errno;
+        ::close(fd);
+        if (map == MAP_FAILED) {
+            return static_cast<std::errc>(err);
+        }
+        m_map = static_cast<const char*>(map);
+        m_length = length;
+
+        std::errc ec = validate(check);
+        if (ec != std::errc()) {
+            close();
+        }
+        return ec;
+    }
+
+    void close() noexcept {
+        if (m_map) {
+            ::munmap(const_cast<char*>(m_map), m_length);
+            m_map = nullptr;
+            m_length = 0;
+        }
+    }
+
+    bool is_open() const noexcept {
+        return m_map != nullptr;
+    }
+
+    const mapped_array_header& header() const noexcept {
+        return *reinterpret_cast<const mapped_array_header*>(m_map);
+    }
+
+    // Elements
+    size_type size() const noexcept { return m_map ? static_cast<size_type>(header().count) : 0; }
+    bool empty() const noexcept { return size() == 0; }
+
+    const value_type* data() const noexcept {
+        return m_map ? reinterpret_cast<const value_type*>(m_map + sizeof(mapped_array_header)) : nullptr;
+    }
+
+    const value_type& operator[](size_type i) const noexcept {
+        return data()[i];
+    }
+
+    const_iterator begin() const noexcept { return data(); }
+    const_iterator end() const noexcept { return data() + size(); }
+
+private:
+    std::errc validate(mapped_check check) const noexcept {
+        const mapped_array_header& h = header();
+        if (std::memcmp(h.magic, mapped_array_magic, sizeof(h.magic)) != 0 || h.version != mapped_array_version ||
+            h.endian != mapped_array_endian || h.capacity != N || h.options != static_cast<std::uint32_t>(Opts) ||
+            h.element_size != sizeof(value_type) || h.element_align != alignof(value_type)) {
+            return std::errc::invalid_argument;
+        }
+        if ((m_length - sizeof(mapped_array_header)) / sizeof(value_type) < h.count ||
+            m_length != sizeof(mapped_array_header) + h.count * sizeof(value_type)) {
+            return std::errc::bad_message;
+        }
+        if (check == mapped_check::contents) {
+            const char* bytes = m_map + sizeof(mapped_array_header);
+            if (mapped_array_checksum(bytes, m_length - sizeof(mapped_array_header)) != h.checksum) {
+                return std::errc::bad_message;
+            }
+            // The size lives inside the element, via its own accessor
+            // (Compact stores N - size, so any byte is in range there)
+            for (const value_type& s : *this) {
+                if (s.size() > s.max_size() || s.data()[s.size()] != '\0') {
+                    return std::errc::bad_message;
+                }
+            }
+        }
+        return std::errc();
+    }
+
+    const char* m_map = nullptr;
+    std::size_t m_length = 0;
+};
+
+template <typename T>
+class mapped_array_writer;
+
+/**
+ * Writes a mapped_array file. Elements are laid out with their unused
+ * bytes zeroed, so the same contents always produce the same file. The
+ * data goes to path + ".tmp", which commit() renames over path, so
+ * readers see either the old file or the complete new one.
+ *
+ *   mapped_array_writer<StackString<32>> out;
+ *   out.open("instruments.ssa");
+ *   for (...) out.push_back(name);
+ *   std::errc ec = out.commit();
+ *
+ * Errors are sticky: after a failure push_back() does nothing and
+ * commit() returns the first error and removes the temporary file.
+ */
+template <std::size_t N, Options Opts>
+class mapped_array_writer<StackString<N, Opts>> {
+public:
+    using value_type = StackString<N, Opts>;
+
+    static_assert(detail::is_mappable_string<value_type>::value, "mapped_array needs a standard-layout StackString");
+
+    mapped_array_writer() = default;
+
+    mapped_array_writer(const mapped_array_writer&) = delete;
+    mapped_array_writer& operator=(const mapped_array_writer&) = delete;
+
+    // Abandons an uncommitted file
+    ~mapped_array_writer() {
+        abandon();
+    }
+
+    std::errc open(const char* path) {
+        abandon();
+        m_path = path;
+        m_temp_path = m_path + ".tmp";
+        m_count = 0;
+        m_checksum = 0;
+        m_used = 0;
+        m_error = std::errc();
+        m_fd = ::open(m_temp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (m_fd < 0) {
+            m_error = static_cast<std::errc>(errno);
+            return m_error;
+        }
+        // Placeholder; the real header is written by commit()
+        mapped_array_header h{};
+        write_bytes(reinterpret_cast<const char*>(&h), sizeof(h));
+        return m_error;
+    }
+
+    // Append text as one element; longer text is truncated as by StackString
+    void push_back(std::string_view text) noexcept {
+        if (m_fd < 0 || m_error != std::errc()) {
+            return;
+        }
+        // Unused bytes and padding are zeroed once the object exists;
+        // zeroing before construction may be discarded as a dead store
+        alignas(value_type) char element[sizeof(value_type)];
+        value_type* s = ::new (static_cast<void*>(element)) value_type();
+        std::memset(element, 0, sizeof(element));
+        s->clear();
+        s->append(text);
+        // Elements may straddle checksum blocks
+        for (std::size_t done = 0; done < sizeof(element);) {
+            std::size_t n = sizeof(m_block) - m_used;
+            n = n < sizeof(element) - done ? n : sizeof(element) - done;
+            std::memcpy(m_block + m_used, element + done, n);
+            m_used += n;
+            done += n;
+            if (m_used == sizeof(m_block)) {
+                flush_block();
+            }
+        }
+        ++m_count;
+    }
+
+    template <std::size_t M, Options O>
+    void push_back(const StackString<M, O>& s) noexcept {
+        push_back(std::string_view(s.data(), s.size()));
+    }
+
+    std::size_t size() const noexcept {
+        return m_count;
+    }
+
+    /**
+     * Write the header, then move the file into place
+     * @return std::errc() on success, otherwise the first error
+     */
+    std::errc commit() noexcept {
+        if (m_fd < 0) {
+            return m_error != std::errc() ? m_error : std::errc::bad_file_descriptor;
+        }
+        flush_block();
+        if (m_error == std::errc()) {
+            mapped_array_header h{};
+            std::memcpy(h.magic, mapped_array_magic, sizeof(h.magic));
+            h.version = mapped_array_version;
+            h.endian = mapped_array_endian;
+            h.capacity = N;
+            h.options = static_cast<std::uint32_t>(Opts);
+            h.element_size = sizeof(value_type);
+            h.element_align = alignof(value_type);
+            h.count = m_count;
+            h.checksum = m_checksum;
+            if (::pwrite(m_fd, &h, sizeof(h), 0) != static_cast<ssize_t>(sizeof(h))) {
+                m_error = static_cast<std::errc>(errno);
+            }
+        }
+        if (m_error == std::errc() && ::fsync(m_fd) != 0) {
+            m_error = static_cast<std::errc>(errno);
+        }
+        if (::close(m_fd) != 0 && m_error == std::errc()) {
+            m_error = static_cast<std::errc>(errno);
+        }
+        m_fd = -1;
+        if (m_error == std::errc() && ::rename(m_temp_path.c_str(), m_path.c_str()) != 0) {
+            m_error = static_cast<std::errc>(errno);
+        }
+        if (m_error != std::errc()) {
+            ::unlink(m_temp_path.c_str());
+        }
+        return m_error;
+    }
+
+private:
+    // Writes whole checksum blocks, except for the last, so the running
+    // checksum matches the reader's block-by-block one
+    void flush_block() noexcept {
+        if (m_used == 0) {
+            return;
+        }
+        m_checksum = detail::hash_bytes(m_block, m_used, m_used, m_checksum);
+        write_bytes(m_block, m_used);
+        m_used = 0;
+    }
+
+    void write_bytes(const char* data, std::size_t size) noexcept {
+        if (m_error != std::errc()) {
+            return;
+        }
+        iovec iov{const_cast<char*>(data), size};
+        m_error = write_all(m_fd, &iov, 1);
+    }
+
+    void abandon() noexcept {
+        if (m_fd >= 0) {
+            ::close(m_fd);
+            ::unlink(m_temp_path.c_str());
+            m_fd = -1;
+        }
+    }
+
+    int m_fd = -1;
+    std::errc m_error{};
+    std::string m_path;
+    std::string m_temp_path;
+    std::size_t m_count = 0;
+    std::uint64_t m_checksum = 0;
+    std::size_t m_used = 0;
+    char m_block[detail::mapped_checksum_block];
+};
+
+} // namespace stack_string
@@ -0,0 +1,182 @@
+#pragma once
+
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+
+namespace stack_string {
+
+/**
+ * Result of parse(): the value, and std::errc() on success. As with
+ * std::from_chars, ec is invalid_argument when the text is not a number
+ * and result_out_of_range when it does not fit in T; in addition, text
+ * left over after the number is invalid_argument.
+ */
+template <typename T>
+struct parse_result {
+    T value{};
+    std::errc ec{};
+
+    constexpr explicit operator bool() const noexcept {
+        return ec == std::errc();
+    }
+};
+
+namespace detail {
+
+inline std::uint64_t parse_load64(const char* p) noexcept {
+    std::uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    v = __builtin_bswap64(v);
+#endif
+    return v;
+}
+
+// True if all 8 bytes of v are '0'..'9': the high nibble is 3, and adding
+// 6 carries out of the low nibble for none of them
+inline bool is_eight_digits(std::uint64_t v) noexcept {
+    return ((v & 0xf0f0f0f0f0f0f0f0ULL) | (((v + 0x0606060606060606ULL) & 0xf0f0f0f0f0f0f0f0ULL) >> 4)) ==
+           0x3333333333333333ULL;
+}
+
+// Value of 8 ASCII digits (first digit in the lowest byte), combining
+// neighbours into 2-, 4- and then 8-digit groups with three multiplies
+inline std::uint32_t parse_eight_digits(std::uint64_t v) noexcept {
+    v -= 0x3030303030303030ULL;
+    v = (v * 10) + (v >> 8);
+    v = (((v & 0x000000ff000000ffULL) * (100 + (1000000ULL << 32))) +
+         (((v >> 16) & 0x000000ff000000ffULL) * (1 + (10000ULL << 32)))) >> 32;
+    return static_cast<std::uint32_t>(v);
+}
+
+/**
+ * Decimal digits only, at most 19 of them (always below 2^64): eight at a
+ * time by SWAR, then one at a time. False if any byte is not a digit.
+ */
+inline bool parse_decimal_digits(const char* p, std::size_t len, std::uint64_t& value) noexcept {
+    std::uint64_t v = 0;
+    std::size_t i = 0;
+    for (; i + 8 <= len; i += 8) {
+        std::uint64_t chunk = parse_load64(p + i);
+        if (!is_eight_digits(chunk)) return false;
+        v = v * 100000000ULL + parse_eight_digits(chunk);
+    }
+    for (; i < len; ++i) {
+        unsigned d = static_cast<unsigned char>(p[i]) - unsigned('0');
+        if (d > 9) return false;
+        v = v * 10 + d;
+    }
+    value = v;
+    return true;
+}
+
+// Base-10 fast path for short fields; false to fall back to from_chars,
+// which then also produces the exact error
+template <typename T>
+bool parse_decimal_fast(std::string_view sv, T& out) noexcept {
+    const char* p = sv.data();
+    std::size_t len = sv.size();
+    bool negative = false;
+    if constexpr (std::is_signed_v<T>) {
+        if (len > 0 && p[0] == '-') {
+            negative = true;
+            ++p;
+            --len;
+        }
+    }
+    std::uint64_t v;
+    if (len == 0 || len > 19 || !parse_decimal_digits(p, len, v)) {
+        return false;
+    }
+    using U = std::make_unsigned_t<T>;
+    if (negative) {
+        // -(max + 1) is the most negative value
+        if (v > static_cast<std::uint64_t>(std::numeric_limits<T>::max()) + 1) return false;
+        out = static_cast<T>(U(0) - static_cast<U>(v));
+    } else {
+        if (v > static_cast<std::uint64_t>(std::numeric_limits<T>::max())) return false;
+        out = static_cast<T>(v);
+    }
+    return true;
+}
+
+template <typename T>
+parse_result<T> from_chars_whole(std::string_view sv, T& value, std::from_chars_result r) noexcept {
+    if (r.ec != std::errc()) return {T{}, r.ec};
+    if (r.ptr != sv.data() + sv.size()) return {T{}, std::errc::invalid_argument};
+    return {value, std::errc()};
+}
+
+} // namespace detail
+
+/**
+ * Parse all of sv as an integer in base (2 to 36), with from_chars rules:
+ * an optional '-' for signed types, no leading '+' or whitespace. Base-10
+ * fields of up to 19 digits take a SWAR path that converts 8 digits at once.
+ */
+template <typename T>
+std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool>, parse_result<T>>
+parse(std::string_view sv, int base = 10) noexcept {
+    T value{};
+    if (base == 10 && detail::parse_decimal_fast(sv, value)) {
+        return {value, std::errc()};
+    }
+    return detail::from_chars_whole(sv, value, std::from_chars(sv.data(), sv.data() + sv.size(), value, base));
+}
+
+// Parse all of sv as a floating-point number in the given format
+template <typename T>
+std::enable_if_t<std::is_floating_point_v<T>, parse_result<T>>
+parse(std::string_view sv, std::chars_format fmt = std::chars_format::general) noexcept {
+    T value{};
+    return detail::from_chars_whole(sv, value, std::from_chars(sv.data(), sv.data() + sv.size(), value, fmt));
+}
+
+// As parse(), with std::nullopt for any error
+template <typename T>
+std::enable_if_t<std::is_arithmetic_v<T> && !std::is_same_v<T, bool>, std::optional<T>>
+to(std::string_view sv) noexcept {
+    parse_result<T> r = parse<T>(sv);
+    if (!r) return std::nullopt;
+    return r.value;
+}
+
+/**
+ * Parse the delim-separated fields of text into out[0, count). Stops at the
+ * first field that fails; value is the number of fields stored. More fields
+ * than count is invalid_argument.
+ */
+template <typename T>
+parse_result<std::size_t> split_parse(std::string_view text, char delim, T* out, std::size_t count) noexcept {
+    std::size_t n = 0;
+    std::size_t pos = 0;
+    for (;;) {
+        std::size_t end = text.find(delim, pos);
+        std::string_view field = text.substr(pos, end == std::string_view::npos ? end : end - pos);
+        if (n == count) return {n, std::errc::invalid_argument};
+        parse_result<T> r = parse<T>(field);
+        if (!r) return {n, r.ec};
+        out[n++] = r.value;
+        if (end == std::string_view::npos) return {n, std::errc()};
+        pos = end + 1;
+    }
+}
+
+// Exactly Count fields, e.g. split_parse<int, 3>("1,2,3", ',')
+template <typename T, std::size_t Count>
+std::optional<std::array<T, Count>> split_parse(std::string_view text, char delim) noexcept {
+    std::array<T, Count> values{};
+    parse_result<std::size_t> r = split_parse(text, delim, values.data(), Count);
+    if (!r || r.value != Count) return std::nullopt;
+    return values;
+}
+
+} // namespace stack_string
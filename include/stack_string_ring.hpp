@@ -0,0 +1,290 @@
+#pragma once
+
+#include "stack_string.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+namespace stack_string {
+
+/**
+ * Producer side of a ring: one producer thread (spsc) or any number (mpsc).
+ * Both variants have a single consumer.
+ */
+enum class ring_mode {
+    spsc,
+    mpsc,
+};
+
+namespace detail {
+
+constexpr std::size_t ring_cache_line = 64;
+
+template <typename T, typename = void>
+struct has_clear : std::false_type {};
+
+template <typename T>
+struct has_clear<T, std::void_t<decltype(std::declval<T&>().clear())>> : std::true_type {};
+
+// Make a reused slot empty: clear() where available (cheap for StackString
+// in any layout), otherwise assign a default value
+template <typename T>
+void reset_slot(T& slot) {
+    if constexpr (has_clear<T>::value) {
+        slot.clear();
+    } else {
+        slot = T();
+    }
+}
+
+// One side's index on its own cache line, next to that side's cached copy
+// of the other index (used by spsc only)
+struct alignas(ring_cache_line) RingIndex {
+    std::atomic<std::size_t> value{0};
+    std::size_t cached_other = 0;
+};
+
+template <typename T, ring_mode Mode>
+struct RingSlot;
+
+template <typename T>
+struct RingSlot<T, ring_mode::spsc> {
+    T value;
+};
+
+// Vyukov's bounded queue: seq == position when free for that producer,
+// position + 1 once committed
+template <typename T>
+struct alignas(ring_cache_line) RingSlot<T, ring_mode::mpsc> {
+    std::atomic<std::size_t> seq;
+    T value;
+};
+
+} // namespace detail
+
+/**
+ * A fixed-size, lock-free ring of T records (usually StackString<N>) stored
+ * inline, for handing formatted lines from hot threads to a background
+ * consumer. Producers format straight into a reserved slot and commit it,
+ * so nothing is copied:
+ *
+ *   ring<StackString<256>, 1024, ring_mode::mpsc> q;
+ *   if (auto r = q.reserve()) {          // nullptr-like when full
+ *       *r << "order " << id << " filled";
+ *       q.commit(r);
+ *   }
+ *   // consumer thread
+ *   while (const StackString<256>* line = q.front()) {
+ *       write(*line);
+ *       q.pop();
+ *   }
+ *
+ * Indices sit on their own cache lines; the spsc variant also caches the
+ * other side's index so a producer only reads the consumer's line when the
+ * ring looks full (and vice versa). In the mpsc variant each slot carries a
+ * sequence number, and slots are consumed in reservation order: a reserved
+ * but uncommitted slot holds back the ones behind it.
+ *
+ * The slots are part of the object (Capacity * sizeof(T) bytes), so large
+ * rings belong in static storage or on the heap rather than on the stack.
+ *
+ * @tparam T Record type (default-constructible)
+ * @tparam Capacity Number of slots, a power of two
+ * @tparam Mode ring_mode::spsc or ring_mode::mpsc
+ */
+template <typename T, std::size_t Capacity, ring_mode Mode = ring_mode::spsc>
+class ring {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "ring capacity must be a power of two");
+
+    using slot_type = detail::RingSlot<T, Mode>;
+
+public:
+    using value_type = T;
+    static constexpr std::size_t capacity = Capacity;
+    static constexpr ring_mode mode = Mode;
+
+    /**
+     * A reserved slot: write through it, then pass it to commit()
+     */
+    class reservation {
+    public:
+        reservation() noexcept = default;
+
+        explicit operator bool() const noexcept {
+            return m_slot != nullptr;
+        }
+
+        T& operator*() const noexcept {
+            return m_slot->value;
+        }
+
+        T* operator->() const noexcept {
+            return &m_slot->value;
+        }
+
+        T* get() const noexcept {
+            return m_slot ? &m_slot->value : nullptr;
+        }
+
+    private:
+        friend class ring;
+
+        reservation(slot_type* slot, std::size_t pos) noexcept
+            : m_slot(slot), m_pos(pos) {}
+
+        slot_type* m_slot = nullptr;
+        std::size_t m_pos = 0;
+    };
+
+    ring() {
+        if constexpr (Mode == ring_mode::mpsc) {
+            for (std::size_t i = 0; i < Capacity; ++i) {
+                m_slots[i].seq.store(i, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    ring(const ring&) = delete;
+    ring& operator=(const ring&) = delete;
+
+    /**
+     * Producer: claim the next slot, emptied for reuse. In the spsc variant
+     * the producer holds at most one reservation at a time.
+     * @return an empty reservation if the ring is full
+     */
+    reservation reserve() noexcept {
+        if constexpr (Mode == ring_mode::spsc) {
+            std::size_t tail = m_tail.value.load(std::memory_order_relaxed);
+            if (tail - m_tail.cached_other >= Capacity) {
+                m_tail.cached_other = m_head.value.load(std::memory_order_acquire);
+                if (tail - m_tail.cached_other >= Capacity) {
+                    return reservation();
+                }
+            }
+            slot_type* slot = &m_slots[tail & (Capacity - 1)];
+            detail::reset_slot(slot->value);
+            return reservation(slot, tail);
+        } else {
+            std::size_t pos = m_tail.value.load(std::memory_order_relaxed);
+            for (;;) {
+                slot_type* slot = &m_slots[pos & (Capacity - 1)];
+                std::size_t seq = slot->seq.load(std::memory_order_acquire);
+                auto diff = static_cast<std::ptrdiff_t>(seq - pos);
+                if (diff == 0) {
+                    if (m_tail.value.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        detail::reset_slot(slot->value);
+                        return reservation(slot, pos);
+                    }
+                } else if (diff < 0) {
+                    return reservation();  // Full: the consumer has not freed it yet
+                } else {
+                    pos = m_tail.value.load(std::memory_order_relaxed);
+                }
+            }
+        }
+    }
+
+    // Producer: publish a reserved slot to the consumer
+    void commit(reservation& r) noexcept {
+        if constexpr (Mode == ring_mode::spsc) {
+            m_tail.value.store(r.m_pos + 1, std::memory_order_release);
+        } else {
+            r.m_slot->seq.store(r.m_pos + 1, std::memory_order_release);
+        }
+        r = reservation();
+    }
+
+    // Producer: copy value in; false if the ring is full
+    bool push(const T& value) {
+        reservation r = reserve();
+        if (!r) {
+            return false;
+        }
+        *r = value;
+        commit(r);
+        return true;
+    }
+
+    /**
+     * Consumer: the oldest committed record, or nullptr if there is none.
+     * It stays valid until pop().
+     */
+    T* front() noexcept {
+        return peek(0);
+    }
+
+    /**
+     * Consumer: the i-th oldest committed record (0 is front()), or nullptr
+     * if fewer than i + 1 are ready. Lets a consumer gather several records
+     * before releasing them together with pop_n().
+     */
+    T* peek(std::size_t i) noexcept {
+        if (i >= Capacity) {
+            return nullptr;
+        }
+        std::size_t head = m_head.value.load(std::memory_order_relaxed);
+        std::size_t pos = head + i;
+        slot_type* slot = &m_slots[pos & (Capacity - 1)];
+        if constexpr (Mode == ring_mode::spsc) {
+            if (i >= m_head.cached_other - head) {
+                m_head.cached_other = m_tail.value.load(std::memory_order_acquire);
+                if (i >= m_head.cached_other - head) {
+                    return nullptr;
+                }
+            }
+        } else {
+            if (slot->seq.load(std::memory_order_acquire) != pos + 1) {
+                return nullptr;
+            }
+        }
+        return &slot->value;
+    }
+
+    // Consumer: release the record returned by front(), which must exist
+    void pop() noexcept {
+        pop_n(1);
+    }
+
+    // Consumer: release the oldest count records, which must all be ready
+    void pop_n(std::size_t count) noexcept {
+        std::size_t head = m_head.value.load(std::memory_order_relaxed);
+        if constexpr (Mode == ring_mode::mpsc) {
+            for (std::size_t pos = head; pos != head + count; ++pos) {
+                m_slots[pos & (Capacity - 1)].seq.store(pos + Capacity, std::memory_order_release);
+            }
+        }
+        m_head.value.store(head + count, std::memory_order_release);
+    }
+
+    // Consumer: move the oldest record out; false if there is none
+    bool pop(T& out) {
+        T* value = front();
+        if (!value) {
+            return false;
+        }
+        out = std::move(*value);
+        pop();
+        return true;
+    }
+
+    // Records reserved and not yet popped; approximate while threads run
+    std::size_t size() const noexcept {
+        std::size_t head = m_head.value.load(std::memory_order_acquire);
+        std::size_t tail = m_tail.value.load(std::memory_order_acquire);
+        return tail - head;
+    }
+
+    bool empty() const noexcept {
+        return size() == 0;
+    }
+
+private:
+    detail::RingIndex m_tail;  // Next position to reserve; caches m_head
+    detail::RingIndex m_head;  // Next position to consume; caches m_tail
+    alignas(detail::ring_cache_line) slot_type m_slots[Capacity];
+};
+
+} // namespace stack_string
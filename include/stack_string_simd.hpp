@@ -0,0 +1,658 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <type_traits>
+
+// Define STACK_STRING_NO_SIMD to force the scalar kernels (e.g. for MSan)
+#if defined(STACK_STRING_NO_SIMD)
+// scalar only
+#elif defined(__AVX2__)
+#include <immintrin.h>
+#define STACK_STRING_SIMD_AVX2 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define STACK_STRING_SIMD_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define STACK_STRING_SIMD_NEON 1
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+#if defined(STACK_STRING_SIMD_AVX2) || defined(STACK_STRING_SIMD_SSE2) || defined(STACK_STRING_SIMD_NEON)
+#define STACK_STRING_HAS_SIMD 1
+#endif
+
+namespace stack_string {
+namespace detail {
+
+/**
+ * True while being evaluated as a constant expression, so constexpr members
+ * can take a scalar path there and SIMD kernels at run time. Without compiler
+ * support this is always false and the SIMD path is not usable in constexpr.
+ */
+constexpr bool is_constant_evaluated() noexcept {
+#if defined(__cpp_lib_is_constant_evaluated)
+    return std::is_constant_evaluated();
+#elif defined(__GNUC__) || defined(__clang__) || (defined(_MSC_VER) && _MSC_VER >= 1925)
+    return __builtin_is_constant_evaluated();
+#else
+    return false;
+#endif
+}
+
+// Index of the lowest / highest set bit; x must be non-zero
+inline unsigned count_trailing_zeros(std::uint64_t x) noexcept {
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index;
+    _BitScanForward64(&index, x);
+    return static_cast<unsigned>(index);
+#else
+    return static_cast<unsigned>(__builtin_ctzll(x));
+#endif
+}
+
+inline unsigned highest_bit(std::uint64_t x) noexcept {
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index;
+    _BitScanReverse64(&index, x);
+    return static_cast<unsigned>(index);
+#else
+    return 63u - static_cast<unsigned>(__builtin_clzll(x));
+#endif
+}
+
+// Number of set bits
+inline unsigned popcount(std::uint64_t x) noexcept {
+#if defined(_MSC_VER) && !defined(__clang__)
+    // __popcnt64 needs the POPCNT instruction, so count by halves instead
+    x -= (x >> 1) & 0x5555555555555555ULL;
+    x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+    x = (x + (x >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+    return static_cast<unsigned>((x * 0x0101010101010101ULL) >> 56);
+#else
+    return static_cast<unsigned>(__builtin_popcountll(x));
+#endif
+}
+
+namespace simd {
+
+// Block loads deliberately read the unused tail of the inline buffer, which
+// may be uninitialized; those lanes are always masked off afterwards
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+/*
+ * One backend is selected at compile time. Each provides:
+ *   width          bytes per block
+ *   lane_bits      mask bits per byte (NEON has no movemask, so it uses 4)
+ *   block          a loaded block
+ *   load(p)        unaligned load of width bytes
+ *   eq(b, c)       mask of bytes in b equal to c
+ *   eq(a, b)       mask of lanes where blocks a and b hold the same byte
+ *   store(p, b)    unaligned store of width bytes
+ *   flip_range(b, lo, count, bits)
+ *                  b with bits xored into each byte in [lo, lo + count)
+ *   flip_eq(b, c, bits)
+ *                  b with bits xored into each byte equal to c
+ */
+#if defined(STACK_STRING_SIMD_AVX2)
+
+constexpr std::size_t width = 32;
+constexpr unsigned lane_bits = 1;
+using block = __m256i;
+
+inline block load(const char* p) noexcept {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+}
+
+inline std::uint64_t eq(block b, char c) noexcept {
+    return static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(b, _mm256_set1_epi8(c))));
+}
+
+inline std::uint64_t eq(block a, block b) noexcept {
+    return static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(a, b)));
+}
+
+inline void store(char* p, block b) noexcept {
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), b);
+}
+
+// Rebase lo to -128 so one signed compare tests the range
+inline block flip_range(block b, char lo, unsigned count, char bits) noexcept {
+    block t = _mm256_add_epi8(b, _mm256_set1_epi8(static_cast<char>(0x80 - static_cast<unsigned char>(lo))));
+    block in = _mm256_cmpgt_epi8(_mm256_set1_epi8(static_cast<char>(static_cast<int>(count) - 128)), t);
+    return _mm256_xor_si256(b, _mm256_and_si256(in, _mm256_set1_epi8(bits)));
+}
+
+inline block flip_eq(block b, char c, char bits) noexcept {
+    block in = _mm256_cmpeq_epi8(b, _mm256_set1_epi8(c));
+    return _mm256_xor_si256(b, _mm256_and_si256(in, _mm256_set1_epi8(bits)));
+}
+
+#elif defined(STACK_STRING_SIMD_SSE2)
+
+constexpr std::size_t width = 16;
+constexpr unsigned lane_bits = 1;
+using block = __m128i;
+
+inline block load(const char* p) noexcept {
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+}
+
+inline std::uint64_t eq(block b, char c) noexcept {
+    return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(b, _mm_set1_epi8(c))));
+}
+
+inline std::uint64_t eq(block a, block b) noexcept {
+    return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(a, b)));
+}
+
+inline void store(char* p, block b) noexcept {
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(p), b);
+}
+
+// Rebase lo to -128 so one signed compare tests the range
+inline block flip_range(block b, char lo, unsigned count, char bits) noexcept {
+    block t = _mm_add_epi8(b, _mm_set1_epi8(static_cast<char>(0x80 - static_cast<unsigned char>(lo))));
+    block in = _mm_cmplt_epi8(t, _mm_set1_epi8(static_cast<char>(static_cast<int>(count) - 128)));
+    return _mm_xor_si128(b, _mm_and_si128(in, _mm_set1_epi8(bits)));
+}
+
+inline block flip_eq(block b, char c, char bits) noexcept {
+    block in = _mm_cmpeq_epi8(b, _mm_set1_epi8(c));
+    return _mm_xor_si128(b, _mm_and_si128(in, _mm_set1_epi8(bits)));
+}
+
+#elif defined(STACK_STRING_SIMD_NEON)
+
+constexpr std::size_t width = 16;
+constexpr unsigned lane_bits = 4;
+using block = uint8x16_t;
+
+inline block load(const char* p) noexcept {
+    return vld1q_u8(reinterpret_cast<const std::uint8_t*>(p));
+}
+
+inline std::uint64_t eq(block b, char c) noexcept {
+    uint8x16_t cmp = vceqq_u8(b, vdupq_n_u8(static_cast<std::uint8_t>(c)));
+    uint8x8_t narrowed = vshrn_n_u16(vreinterpretq_u16_u8(cmp), 4);
+    return vget_lane_u64(vreinterpret_u64_u8(narrowed), 0);
+}
+
+inline std::uint64_t eq(block a, block b) noexcept {
+    uint8x8_t narrowed = vshrn_n_u16(vreinterpretq_u16_u8(vceqq_u8(a, b)), 4);
+    return vget_lane_u64(vreinterpret_u64_u8(narrowed), 0);
+}
+
+inline void store(char* p, block b) noexcept {
+    vst1q_u8(reinterpret_cast<std::uint8_t*>(p), b);
+}
+
+inline block flip_range(block b, char lo, unsigned count, char bits) noexcept {
+    uint8x16_t in = vcltq_u8(vsubq_u8(b, vdupq_n_u8(static_cast<std::uint8_t>(lo))),
+                             vdupq_n_u8(static_cast<std::uint8_t>(count)));
+    return veorq_u8(b, vandq_u8(in, vdupq_n_u8(static_cast<std::uint8_t>(bits))));
+}
+
+inline block flip_eq(block b, char c, char bits) noexcept {
+    uint8x16_t in = vceqq_u8(b, vdupq_n_u8(static_cast<std::uint8_t>(c)));
+    return veorq_u8(b, vandq_u8(in, vdupq_n_u8(static_cast<std::uint8_t>(bits))));
+}
+
+#endif
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+#if defined(STACK_STRING_HAS_SIMD)
+
+// Mask selecting the first n lanes of a block
+inline std::uint64_t lanes_below(std::size_t n) noexcept {
+    return n >= width ? ~std::uint64_t(0) >> (64 - width * lane_bits)
+                      : (std::uint64_t(1) << (n * lane_bits)) - 1;
+}
+
+// Mask selecting lanes [lo, hi) of a block
+inline std::uint64_t lanes_range(std::size_t lo, std::size_t hi) noexcept {
+    return lanes_below(hi) & ~lanes_below(lo);
+}
+
+inline std::size_t first_lane(std::uint64_t mask) noexcept {
+    return count_trailing_zeros(mask) / lane_bits;
+}
+
+inline std::size_t last_lane(std::uint64_t mask) noexcept {
+    return highest_bit(mask) / lane_bits;
+}
+
+// Clear the lowest set lane
+inline std::uint64_t clear_first_lane(std::uint64_t mask) noexcept {
+    return mask & ~(((std::uint64_t(1) << lane_bits) - 1) << (first_lane(mask) * lane_bits));
+}
+
+// Clear the highest set lane
+inline std::uint64_t clear_last_lane(std::uint64_t mask) noexcept {
+    return mask & ~(((std::uint64_t(1) << lane_bits) - 1) << (last_lane(mask) * lane_bits));
+}
+
+#endif
+
+} // namespace simd
+
+/*
+ * Search kernels over data[0, size). `readable` is the number of bytes that
+ * may be loaded from data (the whole inline buffer, not just the string), so
+ * block loads only need a bounds check against the fixed capacity; lanes past
+ * size are masked off. Positions follow std::string_view semantics.
+ */
+
+// Scalar paths go through std::string_view, which is constexpr and uses the
+// C library's memchr/memcmp at run time
+constexpr std::size_t search_npos = std::string_view::npos;
+
+constexpr std::size_t scalar_find(const char* data, std::size_t size, char c, std::size_t pos) noexcept {
+    return std::string_view(data, size).find(c, pos);
+}
+
+constexpr std::size_t scalar_rfind(const char* data, std::size_t size, char c, std::size_t pos) noexcept {
+    return std::string_view(data, size).rfind(c, pos);
+}
+
+constexpr std::size_t scalar_find(const char* data, std::size_t size, std::string_view needle,
+                                  std::size_t pos) noexcept {
+    return std::string_view(data, size).find(needle, pos);
+}
+
+constexpr std::size_t scalar_rfind(const char* data, std::size_t size, std::string_view needle,
+                                   std::size_t pos) noexcept {
+    return std::string_view(data, size).rfind(needle, pos);
+}
+
+constexpr std::size_t scalar_find_of(const char* data, std::size_t size, std::string_view set,
+                                     std::size_t pos, bool in_set) noexcept {
+    return in_set ? std::string_view(data, size).find_first_of(set, pos)
+                  : std::string_view(data, size).find_first_not_of(set, pos);
+}
+
+#if defined(STACK_STRING_HAS_SIMD)
+
+// Start of the last block that can be loaded, for a window of `extra` bytes
+// past each lane: a partial final block is shifted back to end inside the
+// buffer and the lanes before `i` are masked off
+inline std::size_t last_block_start(std::size_t i, std::size_t extra, std::size_t readable) noexcept {
+    return (i + extra + simd::width <= readable) ? i : readable - extra - simd::width;
+}
+
+// Past this many bytes the C library's unrolled, runtime-dispatched memchr
+// wins; the inline kernels target short fields where call overhead dominates
+constexpr std::size_t simd_libc_threshold = 256;
+
+inline std::size_t simd_find(const char* data, std::size_t size, std::size_t readable,
+                             char c, std::size_t pos) noexcept {
+    if (readable < simd::width || pos >= size || size - pos > simd_libc_threshold) {
+        return scalar_find(data, size, c, pos);
+    }
+
+    std::size_t i = pos;
+    // Four blocks per iteration
+    for (; i + 4 * simd::width <= size; i += 4 * simd::width) {
+        std::uint64_t m0 = simd::eq(simd::load(data + i), c);
+        std::uint64_t m1 = simd::eq(simd::load(data + i + simd::width), c);
+        std::uint64_t m2 = simd::eq(simd::load(data + i + 2 * simd::width), c);
+        std::uint64_t m3 = simd::eq(simd::load(data + i + 3 * simd::width), c);
+        if (m0 | m1 | m2 | m3) {
+            if (m0) return i + simd::first_lane(m0);
+            if (m1) return i + simd::width + simd::first_lane(m1);
+            if (m2) return i + 2 * simd::width + simd::first_lane(m2);
+            return i + 3 * simd::width + simd::first_lane(m3);
+        }
+    }
+    for (; i + simd::width <= size; i += simd::width) {
+        std::uint64_t mask = simd::eq(simd::load(data + i), c);
+        if (mask) return i + simd::first_lane(mask);
+    }
+    if (i >= size) return search_npos;
+
+    // Final partial block: read into the spare capacity and mask it off
+    std::size_t j = last_block_start(i, 0, readable);
+    std::uint64_t mask = simd::eq(simd::load(data + j), c) & simd::lanes_range(i - j, size - j);
+    return mask ? j + simd::first_lane(mask) : search_npos;
+}
+
+inline std::size_t simd_rfind(const char* data, std::size_t size, std::size_t readable,
+                              char c, std::size_t pos) noexcept {
+    if (readable < simd::width) return scalar_rfind(data, size, c, pos);
+
+    std::size_t end = pos < size ? pos + 1 : size;
+    for (; end >= simd::width; end -= simd::width) {
+        std::uint64_t mask = simd::eq(simd::load(data + end - simd::width), c);
+        if (mask) return end - simd::width + simd::last_lane(mask);
+    }
+    if (end == 0) return search_npos;
+
+    std::uint64_t mask = simd::eq(simd::load(data), c) & simd::lanes_below(end);
+    return mask ? simd::last_lane(mask) : search_npos;
+}
+
+// Candidate positions for needle in a block at p: first and last bytes match
+inline std::uint64_t substr_candidates(const char* p, std::string_view needle) noexcept {
+    return simd::eq(simd::load(p), needle.front()) &
+           simd::eq(simd::load(p + needle.size() - 1), needle.back());
+}
+
+// Verify candidates from the lowest lane; returns the first match or npos
+inline std::size_t first_verified(const char* data, std::size_t base, std::uint64_t mask,
+                                  std::string_view needle) noexcept {
+    while (mask) {
+        std::size_t candidate = base + simd::first_lane(mask);
+        if (std::memcmp(data + candidate + 1, needle.data() + 1, needle.size() - 2) == 0) {
+            return candidate;
+        }
+        mask = simd::clear_first_lane(mask);
+    }
+    return search_npos;
+}
+
+// Verify candidates from the highest lane; returns the last match or npos
+inline std::size_t last_verified(const char* data, std::size_t base, std::uint64_t mask,
+                                 std::string_view needle) noexcept {
+    while (mask) {
+        std::size_t candidate = base + simd::last_lane(mask);
+        if (std::memcmp(data + candidate + 1, needle.data() + 1, needle.size() - 2) == 0) {
+            return candidate;
+        }
+        mask = simd::clear_last_lane(mask);
+    }
+    return search_npos;
+}
+
+// Substring search comparing the needle's first and last bytes a block at a
+// time; only candidate positions are verified with memcmp
+inline std::size_t simd_find(const char* data, std::size_t size, std::size_t readable,
+                             std::string_view needle, std::size_t pos) noexcept {
+    const std::size_t n = needle.size();
+    if (pos > size || n > size - pos) return search_npos;
+    if (n == 0) return pos;
+    if (n == 1) return simd_find(data, size, readable, needle[0], pos);
+    if (readable < n - 1 + simd::width) return scalar_find(data, size, needle, pos);
+
+    const std::size_t last = size - n + 1; // candidates are [pos, last)
+    std::size_t i = pos;
+    for (; i + simd::width <= last; i += simd::width) {
+        std::uint64_t mask = substr_candidates(data + i, needle);
+        if (mask) {
+            std::size_t found = first_verified(data, i, mask, needle);
+            if (found != search_npos) return found;
+        }
+    }
+    if (i >= last) return search_npos;
+
+    std::size_t j = last_block_start(i, n - 1, readable);
+    std::uint64_t mask = substr_candidates(data + j, needle) & simd::lanes_range(i - j, last - j);
+    return first_verified(data, j, mask, needle);
+}
+
+inline std::size_t simd_rfind(const char* data, std::size_t size, std::size_t readable,
+                              std::string_view needle, std::size_t pos) noexcept {
+    const std::size_t n = needle.size();
+    if (n > size) return search_npos;
+    if (n == 0) return pos < size ? pos : size;
+    if (n == 1) return simd_rfind(data, size, readable, needle[0], pos);
+    if (readable < n - 1 + simd::width) return scalar_rfind(data, size, needle, pos);
+
+    // Candidates are [0, end)
+    std::size_t end = (pos < size - n ? pos : size - n) + 1;
+    for (; end >= simd::width; end -= simd::width) {
+        std::uint64_t mask = substr_candidates(data + end - simd::width, needle);
+        if (mask) {
+            std::size_t found = last_verified(data, end - simd::width, mask, needle);
+            if (found != search_npos) return found;
+        }
+    }
+    if (end == 0) return search_npos;
+
+    std::uint64_t mask = substr_candidates(data, needle) & simd::lanes_below(end);
+    return last_verified(data, 0, mask, needle);
+}
+
+// Equality of a[0, size) and b[0, size) a block at a time; `readable` bytes
+// may be loaded from both. With a fixed capacity the loop has a fixed upper
+// bound, and a partial final block is shifted back like the search kernels.
+inline bool simd_equal(const char* a, const char* b, std::size_t size, std::size_t readable) noexcept {
+    if (readable < simd::width) return std::memcmp(a, b, size) == 0;
+
+    std::size_t i = 0;
+    for (; i + simd::width <= size; i += simd::width) {
+        if (simd::eq(simd::load(a + i), simd::load(b + i)) != simd::lanes_below(simd::width)) {
+            return false;
+        }
+    }
+    if (i >= size) return true;
+
+    std::size_t j = last_block_start(i, 0, readable);
+    std::uint64_t lanes = simd::lanes_range(i - j, size - j);
+    return (simd::eq(simd::load(a + j), simd::load(b + j)) & lanes) == lanes;
+}
+
+// Sets larger than this use a byte table instead of one compare per member
+constexpr std::size_t simd_max_set_size = 8;
+
+// Lanes of the block at p whose byte is (in_set) or is not (!in_set) in set
+inline std::uint64_t set_lanes(const char* p, std::string_view set, bool in_set) noexcept {
+    simd::block b = simd::load(p);
+    std::uint64_t mask = 0;
+    for (char c : set) mask |= simd::eq(b, c);
+    return in_set ? mask : ~mask & simd::lanes_below(simd::width);
+}
+
+inline std::size_t simd_find_of(const char* data, std::size_t size, std::size_t readable,
+                                std::string_view set, std::size_t pos, bool in_set) noexcept {
+    if (set.size() > simd_max_set_size) {
+        bool table[256] = {};
+        for (char c : set) table[static_cast<unsigned char>(c)] = true;
+        for (std::size_t i = pos; i < size; ++i) {
+            if (table[static_cast<unsigned char>(data[i])] == in_set) return i;
+        }
+        return search_npos;
+    }
+    if (readable < simd::width) return scalar_find_of(data, size, set, pos, in_set);
+    if (pos >= size) return search_npos;
+
+    std::size_t i = pos;
+    for (; i + simd::width <= size; i += simd::width) {
+        std::uint64_t mask = set_lanes(data + i, set, in_set);
+        if (mask) return i + simd::first_lane(mask);
+    }
+    if (i >= size) return search_npos;
+
+    std::size_t j = last_block_start(i, 0, readable);
+    std::uint64_t mask = set_lanes(data + j, set, in_set) & simd::lanes_range(i - j, size - j);
+    return mask ? j + simd::first_lane(mask) : search_npos;
+}
+
+#endif
+
+/*
+ * In-place transform kernels over data[0, size): each byte in a range, or
+ * equal to a character, gets bits xored in. `readable` bytes may be loaded;
+ * with a fixed capacity it removes the paths a short string cannot take.
+ * Blocks of simd::width bytes are processed at a time, else 8-byte words
+ * (SWAR), a string shorter than a word being masked within one. Only bytes
+ * before size ever change, so a Compact string's size byte is safe. The
+ * transforms are idempotent ('A'-'Z' to 'a'-'z' leaves the result alone), so
+ * the final block is shifted back to end at size and may overlap the one
+ * before it.
+ */
+
+constexpr std::uint64_t swar_ones = 0x0101010101010101ull;
+constexpr std::uint64_t swar_high = 0x8080808080808080ull;
+
+// The bytes of a word stored at the n lowest addresses (n < 8)
+inline std::uint64_t swar_low_bytes(std::size_t n) noexcept {
+    std::uint64_t bytes = (std::uint64_t(1) << (8 * n)) - 1;
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    bytes = ~(~std::uint64_t(0) >> (8 * n));
+#endif
+    return bytes;
+}
+
+// High bit of each byte of w in [lo, lo + count); lo + count <= 128, so
+// bytes with the high bit set never match
+constexpr std::uint64_t swar_in_range(std::uint64_t w, unsigned char lo, unsigned count) noexcept {
+    std::uint64_t low7 = w & ~swar_high;
+    std::uint64_t at_least_lo = low7 + swar_ones * (0x80u - lo);
+    std::uint64_t at_least_hi = low7 + swar_ones * (0x80u - lo - count);
+    return at_least_lo & ~at_least_hi & ~w & swar_high;
+}
+
+// High bit of each byte of w equal to c
+constexpr std::uint64_t swar_equal(std::uint64_t w, char c) noexcept {
+    std::uint64_t t = w ^ (swar_ones * static_cast<unsigned char>(c));
+    return ~(((t & ~swar_high) + ~swar_high) | t) & swar_high;
+}
+
+struct FlipRange {
+    char lo;
+    unsigned count;
+    char bits;
+
+#if defined(STACK_STRING_HAS_SIMD)
+    simd::block operator()(simd::block b) const noexcept {
+        return simd::flip_range(b, lo, count, bits);
+    }
+#endif
+
+    constexpr std::uint64_t operator()(std::uint64_t w) const noexcept {
+        return w ^ ((swar_in_range(w, static_cast<unsigned char>(lo), count) >> 7) * static_cast<unsigned char>(bits));
+    }
+
+    constexpr char operator()(char c) const noexcept {
+        return static_cast<unsigned char>(c - lo) < count ? static_cast<char>(c ^ bits) : c;
+    }
+};
+
+struct FlipEqual {
+    char c;
+    char bits;
+
+#if defined(STACK_STRING_HAS_SIMD)
+    simd::block operator()(simd::block b) const noexcept {
+        return simd::flip_eq(b, c, bits);
+    }
+#endif
+
+    constexpr std::uint64_t operator()(std::uint64_t w) const noexcept {
+        return w ^ ((swar_equal(w, c) >> 7) * static_cast<unsigned char>(bits));
+    }
+
+    constexpr char operator()(char x) const noexcept {
+        return x == c ? static_cast<char>(x ^ bits) : x;
+    }
+};
+
+template <typename Op>
+constexpr void transform_chars(char* data, std::size_t size, std::size_t readable, const Op& op) noexcept {
+    if (!is_constant_evaluated()) {
+#if defined(STACK_STRING_HAS_SIMD)
+        if (readable >= simd::width && size >= simd::width) {
+            // The final block is loaded before anything is stored, so it
+            // never waits on a partly overlapping store
+            simd::block tail = op(simd::load(data + size - simd::width));
+            for (std::size_t i = 0; i + simd::width < size; i += simd::width) {
+                simd::store(data + i, op(simd::load(data + i)));
+            }
+            simd::store(data + size - simd::width, tail);
+            return;
+        }
+#endif
+        if (readable >= sizeof(std::uint64_t)) {
+            auto load = [data](std::size_t at) {
+                std::uint64_t w;
+                std::memcpy(&w, data + at, sizeof(w));
+                return w;
+            };
+            auto store = [data](std::size_t at, std::uint64_t w) { std::memcpy(data + at, &w, sizeof(w)); };
+            if (size < sizeof(std::uint64_t)) {
+                // Only the bytes below size take the transformed value
+                std::uint64_t w = load(0);
+                store(0, w ^ ((w ^ op(w)) & swar_low_bytes(size)));
+                return;
+            }
+            std::uint64_t tail = op(load(size - sizeof(std::uint64_t)));
+            for (std::size_t i = 0; i + sizeof(std::uint64_t) < size; i += sizeof(std::uint64_t)) {
+                store(i, op(load(i)));
+            }
+            store(size - sizeof(std::uint64_t), tail);
+            return;
+        }
+    }
+    for (std::size_t i = 0; i < size; ++i) {
+        data[i] = op(data[i]);
+    }
+}
+
+constexpr std::size_t find_char(const char* data, std::size_t size, std::size_t readable,
+                                char c, std::size_t pos) noexcept {
+#if defined(STACK_STRING_HAS_SIMD)
+    if (!is_constant_evaluated()) return simd_find(data, size, readable, c, pos);
+#endif
+    (void)readable;
+    return scalar_find(data, size, c, pos);
+}
+
+constexpr std::size_t rfind_char(const char* data, std::size_t size, std::size_t readable,
+                                 char c, std::size_t pos) noexcept {
+#if defined(STACK_STRING_HAS_SIMD)
+    if (!is_constant_evaluated()) return simd_rfind(data, size, readable, c, pos);
+#endif
+    (void)readable;
+    return scalar_rfind(data, size, c, pos);
+}
+
+constexpr std::size_t find_substr(const char* data, std::size_t size, std::size_t readable,
+                                  std::string_view needle, std::size_t pos) noexcept {
+#if defined(STACK_STRING_HAS_SIMD)
+    if (!is_constant_evaluated()) return simd_find(data, size, readable, needle, pos);
+#endif
+    (void)readable;
+    return scalar_find(data, size, needle, pos);
+}
+
+constexpr std::size_t rfind_substr(const char* data, std::size_t size, std::size_t readable,
+                                   std::string_view needle, std::size_t pos) noexcept {
+#if defined(STACK_STRING_HAS_SIMD)
+    if (!is_constant_evaluated()) return simd_rfind(data, size, readable, needle, pos);
+#endif
+    (void)readable;
+    return scalar_rfind(data, size, needle, pos);
+}
+
+constexpr std::size_t find_of(const char* data, std::size_t size, std::size_t readable,
+                              std::string_view set, std::size_t pos, bool in_set) noexcept {
+#if defined(STACK_STRING_HAS_SIMD)
+    if (!is_constant_evaluated()) return simd_find_of(data, size, readable, set, pos, in_set);
+#endif
+    (void)readable;
+    return scalar_find_of(data, size, set, pos, in_set);
+}
+
+constexpr bool equal_chars(const char* a, const char* b, std::size_t size,
+                           std::size_t readable) noexcept {
+#if defined(STACK_STRING_HAS_SIMD)
+    if (!is_constant_evaluated()) return simd_equal(a, b, size, readable);
+#endif
+    (void)readable;
+    return std::string_view(a, size) == std::string_view(b, size);
+}
+
+} // namespace detail
+} // namespace stack_string
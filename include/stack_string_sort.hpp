@@ -0,0 +1,162 @@
+#pragma once
+
+#include "stack_string.hpp"
+
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+namespace stack_string {
+
+namespace detail {
+
+// Ranges this short are finished with an insertion sort
+constexpr std::ptrdiff_t radix_insertion_threshold = 32;
+
+// Bucket of s at depth: 0 once the string has ended (so shorter strings
+// order first), otherwise the byte as unsigned char plus one
+template <typename S>
+inline std::size_t radix_key(const S& s, std::size_t depth) noexcept {
+    return depth < s.size() ? static_cast<std::size_t>(static_cast<unsigned char>(s.data()[depth])) + 1 : 0;
+}
+
+// Swap two elements with one fixed-size copy each way instead of the
+// used-bytes copies (with their variable lengths) of operator=. Only a
+// TriviallyCopyable StackString may be copied as bytes; any other layout
+// has user-provided copies and goes through its swap(), which assigns the
+// layers beneath them.
+template <typename S>
+inline void radix_swap(S& a, S& b) noexcept {
+    if constexpr (std::is_trivially_copyable_v<S>) {
+        unsigned char bytes[sizeof(S)];
+        std::memcpy(bytes, &a, sizeof(S));
+        std::memcpy(&a, &b, sizeof(S));
+        std::memcpy(&b, bytes, sizeof(S));
+    } else {
+        using std::swap;
+        swap(a, b);
+    }
+}
+
+// Sort a range whose elements share their first depth bytes
+template <typename RandomIt>
+void radix_insertion_sort(RandomIt first, RandomIt last, std::size_t depth) noexcept {
+    using value_type = typename std::iterator_traits<RandomIt>::value_type;
+    auto tail = [depth](const value_type& s) { return std::string_view(s.data() + depth, s.size() - depth); };
+    for (RandomIt i = first + 1; i < last; ++i) {
+        if (!(tail(*i) < tail(*(i - 1)))) {
+            continue;
+        }
+        value_type moving = std::move(*i);
+        RandomIt j = i;
+        do {
+            *j = std::move(*(j - 1));
+            --j;
+        } while (j != first && tail(moving) < tail(*(j - 1)));
+        *j = std::move(moving);
+    }
+}
+
+/**
+ * One American flag pass: count the keys at depth, then swap every element
+ * into its bucket in place. ends[b] is the offset one past bucket b.
+ * @return false (and nothing moved) if every element has the same key
+ */
+template <typename RandomIt>
+bool radix_partition(RandomIt first, std::size_t n, std::size_t depth, std::size_t (&ends)[257]) noexcept {
+    std::size_t heads[257] = {};
+    for (std::size_t i = 0; i < n; ++i) {
+        ++heads[radix_key(first[i], depth)];
+    }
+    std::size_t offset = 0;
+    for (std::size_t b = 0; b < 257; ++b) {
+        if (heads[b] == n) {
+            return false;
+        }
+        std::size_t count = heads[b];
+        heads[b] = offset;
+        offset += count;
+        ends[b] = offset;
+    }
+    for (std::size_t b = 0; b < 257; ++b) {
+        while (heads[b] < ends[b]) {
+            std::size_t key = radix_key(first[heads[b]], depth);
+            while (key != b) {
+                radix_swap(first[heads[b]], first[heads[key]++]);
+                key = radix_key(first[heads[b]], depth);
+            }
+            ++heads[b];
+        }
+    }
+    return true;
+}
+
+template <typename RandomIt>
+void radix_sort_from(RandomIt first, RandomIt last, std::size_t depth, std::size_t max_depth) noexcept {
+    std::size_t ends[257];
+    for (;;) {
+        if (last - first < radix_insertion_threshold) {
+            radix_insertion_sort(first, last, depth);
+            return;
+        }
+        // No string is longer than N: what is left is all equal
+        if (depth == max_depth) {
+            return;
+        }
+        std::size_t n = static_cast<std::size_t>(last - first);
+        if (!radix_partition(first, n, depth, ends)) {
+            if (radix_key(*first, depth) == 0) {
+                return;
+            }
+            ++depth;
+            continue;
+        }
+        // Bucket 0 holds strings that ended, already in order. Recurse into
+        // all but the largest bucket, which is at most half of the range,
+        // and loop on the largest: the stack stays O(log n) deep.
+        std::size_t largest = 1;
+        for (std::size_t b = 2; b < 257; ++b) {
+            if (ends[b] - ends[b - 1] > ends[largest] - ends[largest - 1]) {
+                largest = b;
+            }
+        }
+        for (std::size_t b = 1; b < 257; ++b) {
+            if (b != largest && ends[b] - ends[b - 1] > 1) {
+                radix_sort_from(first + ends[b - 1], first + ends[b], depth + 1, max_depth);
+            }
+        }
+        last = first + ends[largest];
+        first += ends[largest - 1];
+        ++depth;
+    }
+}
+
+} // namespace detail
+
+/**
+ * Sort a range of StackStrings into the order of operator<, an MSD radix
+ * sort on the bytes. It runs in place, sorting on one byte per pass with
+ * the same 257 buckets at every level; no pass goes deeper than N bytes,
+ * however many strings have long common prefixes. Elements are
+ * swapped (whole objects for a TriviallyCopyable layout), so it suits the
+ * small N that StackStrings usually have.
+ * Equal strings may be reordered (not stable). Ranges under 32 elements
+ * go straight to an insertion sort.
+ *
+ *   std::vector<StackString<16>> symbols = load();
+ *   radix_sort(symbols.begin(), symbols.end());
+ */
+template <typename RandomIt>
+void radix_sort(RandomIt first, RandomIt last) noexcept {
+    using value_type = typename std::iterator_traits<RandomIt>::value_type;
+    static_assert(detail::is_stack_string<value_type>::value, "radix_sort sorts ranges of StackString");
+    if (last - first < 2) {
+        return;
+    }
+    detail::radix_sort_from(first, last, 0, value_type::capacity);  // resize() can fill all N
+}
+
+} // namespace stack_string
@@ -0,0 +1,340 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <new>
+
+// Define STACK_STRING_STATS to count, for every StackString<N, Opts> type
+// (or for a tag in scope), the writes that truncated, the sizes writes
+// leave relative to N and the peak size. Without it nothing is recorded
+// and StackString compiles to the same code.
+
+#if !defined(STACK_STRING_STATS_MAX_SITES)
+// Sites (types and tags) with counters; later ones are not counted
+#define STACK_STRING_STATS_MAX_SITES 128
+#endif
+
+namespace stack_string {
+
+#if defined(STACK_STRING_STATS)
+constexpr bool string_stats_enabled = true;
+#else
+constexpr bool string_stats_enabled = false;
+#endif
+
+// Size histogram buckets: bucket k counts sizes in [k * N / 8, (k + 1) * N / 8),
+// the last one also a string filled to N by resize()
+constexpr std::size_t string_stats_buckets = 8;
+
+/**
+ * Counters of one site, summed over all threads. A write is any operation
+ * that sets the size (append, assign, resize, insert, ...), so a string
+ * built by ten appends contributes ten samples. Writes that leave the
+ * string empty, as every constructor starts with, are not sampled.
+ */
+struct string_stats {
+    std::uint64_t writes = 0;       // Writes sampled
+    std::uint64_t truncations = 0;  // Writes that dropped characters
+    std::uint64_t peak_size = 0;    // Largest size any write left
+    std::uint64_t histogram[string_stats_buckets] = {};
+};
+
+class string_stats_site;
+
+namespace detail {
+
+// One site's counters in one thread's block. Only the owning thread
+// writes them, with a plain load and store; readers load them relaxed.
+struct string_stats_counters {
+    std::atomic<std::uint64_t> writes{0};
+    std::atomic<std::uint64_t> truncations{0};
+    std::atomic<std::uint64_t> peak_size{0};
+    std::atomic<std::uint64_t> histogram[string_stats_buckets] = {};
+};
+
+inline void string_stats_bump(std::atomic<std::uint64_t>& counter) noexcept {
+    counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+/**
+ * The counters of every site for one thread. Blocks are pushed onto a
+ * lock-free list and never freed: when a thread exits its block is
+ * released, and the next new thread adopts it, adding to its counts.
+ */
+struct string_stats_block {
+    string_stats_counters sites[STACK_STRING_STATS_MAX_SITES];
+    std::atomic<bool> in_use{true};
+    string_stats_block* next = nullptr;
+
+    static std::atomic<string_stats_block*>& list_head() noexcept {
+        static std::atomic<string_stats_block*> head{nullptr};
+        return head;
+    }
+
+    // A released block, else a new one; nullptr if allocation fails
+    static string_stats_block* acquire() noexcept {
+        std::atomic<string_stats_block*>& head = list_head();
+        for (string_stats_block* b = head.load(std::memory_order_acquire); b; b = b->next) {
+            bool expected = false;
+            if (!b->in_use.load(std::memory_order_relaxed) &&
+                b->in_use.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+                return b;
+            }
+        }
+        string_stats_block* b = new (std::nothrow) string_stats_block;
+        if (b) {
+            b->next = head.load(std::memory_order_relaxed);
+            while (!head.compare_exchange_weak(b->next, b, std::memory_order_release, std::memory_order_relaxed)) {
+            }
+        }
+        return b;
+    }
+};
+
+// Per-thread state: the site a string_stats_scope redirects to, and the
+// counter block, acquired on the first write
+struct string_stats_thread {
+    string_stats_site* scope = nullptr;
+    string_stats_block* block = nullptr;
+    bool acquired = false;
+
+    ~string_stats_thread() {
+        if (block) {
+            block->in_use.store(false, std::memory_order_release);
+        }
+    }
+
+    string_stats_block* counters() noexcept {
+        if (!acquired) {
+            acquired = true;
+            block = string_stats_block::acquire();
+        }
+        return block;
+    }
+};
+
+inline string_stats_thread& string_stats_this_thread() noexcept {
+    static thread_local string_stats_thread state;
+    return state;
+}
+
+} // namespace detail
+
+/**
+ * Counters for a StackString type or a tag: a slot in every thread's
+ * block and an entry in the lock-free site list. Sites must have static
+ * storage duration.
+ */
+class string_stats_site {
+public:
+    string_stats_site(const char* name, std::size_t capacity, unsigned options, const char* file, int line) noexcept
+        : m_name(name), m_file(file), m_line(line), m_capacity(capacity), m_options(options) {
+        m_index = next_index().fetch_add(1, std::memory_order_relaxed);
+        std::atomic<const string_stats_site*>& head = list_head();
+        m_next = head.load(std::memory_order_relaxed);
+        while (!head.compare_exchange_weak(m_next, this, std::memory_order_release, std::memory_order_relaxed)) {
+        }
+    }
+
+    string_stats_site(const string_stats_site&) = delete;
+    string_stats_site& operator=(const string_stats_site&) = delete;
+
+    const char* name() const noexcept { return m_name; }
+    const char* file() const noexcept { return m_file; }
+    int line() const noexcept { return m_line; }
+
+    // N of a type's site; 0 for a tag, which sees StackStrings of any N
+    std::size_t capacity() const noexcept { return m_capacity; }
+    unsigned options() const noexcept { return m_options; }
+
+    // False if the site came after the first STACK_STRING_STATS_MAX_SITES
+    bool counted() const noexcept { return m_index < STACK_STRING_STATS_MAX_SITES; }
+
+    // Sum over all threads, live or exited; safe from any thread
+    string_stats stats() const noexcept {
+        string_stats s;
+        if (!counted()) {
+            return s;
+        }
+        const detail::string_stats_block* b = detail::string_stats_block::list_head().load(std::memory_order_acquire);
+        for (; b; b = b->next) {
+            const detail::string_stats_counters& c = b->sites[m_index];
+            s.writes += c.writes.load(std::memory_order_relaxed);
+            s.truncations += c.truncations.load(std::memory_order_relaxed);
+            std::uint64_t peak = c.peak_size.load(std::memory_order_relaxed);
+            s.peak_size = peak > s.peak_size ? peak : s.peak_size;
+            for (std::size_t k = 0; k < string_stats_buckets; ++k) {
+                s.histogram[k] += c.histogram[k].load(std::memory_order_relaxed);
+            }
+        }
+        return s;
+    }
+
+    const string_stats_site* next() const noexcept { return m_next; }
+
+    // Most recently registered site; next() walks the rest
+    static const string_stats_site* first() noexcept {
+        return list_head().load(std::memory_order_acquire);
+    }
+
+    // This thread's counters for the site, or nullptr if not counted
+    detail::string_stats_counters* local() noexcept {
+        detail::string_stats_block* b = counted() ? detail::string_stats_this_thread().counters() : nullptr;
+        return b ? &b->sites[m_index] : nullptr;
+    }
+
+private:
+    static std::atomic<std::size_t>& next_index() noexcept {
+        static std::atomic<std::size_t> index{0};
+        return index;
+    }
+
+    // Type sites register on first use, so from any thread
+    static std::atomic<const string_stats_site*>& list_head() noexcept {
+        static std::atomic<const string_stats_site*> head{nullptr};
+        return head;
+    }
+
+    const char* m_name;
+    const char* m_file;
+    int m_line;
+    std::size_t m_capacity;
+    unsigned m_options;
+    std::size_t m_index;
+    const string_stats_site* m_next = nullptr;
+};
+
+/**
+ * A named set of counters. Writes to StackStrings of any type made while
+ * a string_stats_scope for the tag is active on the thread go to the tag
+ * instead of their type. Must have static storage duration (see
+ * STACK_STRING_STATS_TAG).
+ */
+class string_stats_tag : public string_stats_site {
+public:
+    explicit string_stats_tag(const char* name, const char* file = nullptr, int line = 0) noexcept
+        : string_stats_site(name, 0, 0, file, line) {}
+};
+
+/**
+ * A tag for the call site, named name and labelled with its file and line:
+ *   string_stats_scope scope(STACK_STRING_STATS_TAG("order_parser"));
+ */
+#define STACK_STRING_STATS_TAG(name)                                         \
+    ([]() -> ::stack_string::string_stats_tag& {                             \
+        static ::stack_string::string_stats_tag tag(name, __FILE__, __LINE__); \
+        return tag;                                                          \
+    }())
+
+/**
+ * Attribute this thread's StackString writes to tag until destroyed.
+ * Scopes nest; a no-op unless STACK_STRING_STATS is defined.
+ */
+class string_stats_scope {
+public:
+    explicit string_stats_scope(string_stats_tag& tag) noexcept {
+        if constexpr (string_stats_enabled) {
+            detail::string_stats_thread& t = detail::string_stats_this_thread();
+            m_previous = t.scope;
+            t.scope = &tag;
+        }
+    }
+
+    ~string_stats_scope() {
+        if constexpr (string_stats_enabled) {
+            detail::string_stats_this_thread().scope = m_previous;
+        }
+    }
+
+    string_stats_scope(const string_stats_scope&) = delete;
+    string_stats_scope& operator=(const string_stats_scope&) = delete;
+
+private:
+    string_stats_site* m_previous = nullptr;
+};
+
+namespace detail {
+
+// The site of StackString<N, Opts>, registered on first use
+template <std::size_t N, unsigned Options>
+string_stats_site& string_stats_type_site() noexcept {
+    static string_stats_site site("StackString", N, Options, nullptr, 0);
+    return site;
+}
+
+template <std::size_t N, unsigned Options>
+string_stats_site& string_stats_current_site() noexcept {
+    string_stats_site* scope = string_stats_this_thread().scope;
+    return scope ? *scope : string_stats_type_site<N, Options>();
+}
+
+// A write left a StackString<N, Options> holding size characters
+template <std::size_t N, unsigned Options>
+void string_stats_record_size(std::size_t size) noexcept {
+    string_stats_counters* c = string_stats_current_site<N, Options>().local();
+    if (!c) {
+        return;
+    }
+    string_stats_bump(c->writes);
+    // resize() can fill all N characters: that counts in the last bucket
+    std::size_t bucket = N > 0 ? size * string_stats_buckets / N : 0;
+    string_stats_bump(c->histogram[bucket < string_stats_buckets ? bucket : string_stats_buckets - 1]);
+    if (size > c->peak_size.load(std::memory_order_relaxed)) {
+        c->peak_size.store(size, std::memory_order_relaxed);
+    }
+}
+
+// A write to a StackString<N, Options> dropped characters
+template <std::size_t N, unsigned Options>
+void string_stats_record_truncation() noexcept {
+    if (string_stats_counters* c = string_stats_current_site<N, Options>().local()) {
+        string_stats_bump(c->truncations);
+    }
+}
+
+} // namespace detail
+
+/**
+ * The site of a StackString type, registering it if no write has yet:
+ *   string_stats_of<StackString<64>>().stats().truncations
+ */
+template <typename S>
+const string_stats_site& string_stats_of() noexcept {
+    return detail::string_stats_type_site<S::capacity, static_cast<unsigned>(S::options)>();
+}
+
+/**
+ * Call fn(site) for every registered site: each StackString type written
+ * so far, and each tag
+ */
+template <typename Fn>
+void for_each_string_stats(Fn&& fn) {
+    for (const string_stats_site* site = string_stats_site::first(); site; site = site->next()) {
+        fn(*site);
+    }
+}
+
+/**
+ * Print one line per site; safe to call from a background thread while
+ * other threads write
+ */
+inline void dump_string_stats(std::FILE* out = stderr) {
+    for_each_string_stats([out](const string_stats_site& site) {
+        string_stats s = site.stats();
+        if (site.capacity() > 0) {
+            std::fprintf(out, "%s<%zu, options=%u>:", site.name(), site.capacity(), site.options());
+        } else {
+            std::fprintf(out, "%s (%s:%d):", site.name(), site.file() ? site.file() : "?", site.line());
+        }
+        std::fprintf(out, " writes=%llu truncations=%llu peak=%llu histogram=", static_cast<unsigned long long>(s.writes),
+                     static_cast<unsigned long long>(s.truncations), static_cast<unsigned long long>(s.peak_size));
+        for (std::size_t k = 0; k < string_stats_buckets; ++k) {
+            std::fprintf(out, k ? ",%llu" : "%llu", static_cast<unsigned long long>(s.histogram[k]));
+        }
+        std::fprintf(out, "%s\n", site.counted() ? "" : " (not counted)");
+    });
+}
+
+} // namespace stack_string
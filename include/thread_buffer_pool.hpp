@@ -0,0 +1,307 @@
+#pragma once
+
+#include "fixed_buf_allocator.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+namespace stack_string {
+
+class thread_buffer_pool;
+
+namespace detail {
+
+class BufferPoolCache;
+
+// Precedes every pooled block; padded so the data is cache-line aligned
+struct alignas(64) BufferPoolBlock {
+    BufferPoolCache* owner;
+    BufferPoolBlock* next;
+    unsigned size_class;
+
+    char* data() noexcept {
+        return reinterpret_cast<char*>(this + 1);
+    }
+};
+
+/**
+ * One thread's cache: a plain free list per size class, owned by the thread,
+ * plus a lock-free list that other threads push returned blocks onto. The
+ * owner takes that list over with a single exchange, so there is no ABA.
+ *
+ * The cache is reference counted by its live blocks plus one for the thread.
+ * At thread exit the return list is closed; blocks returned afterwards are
+ * freed by the returning thread, and the last reference deletes the cache.
+ */
+class BufferPoolCache {
+public:
+    static constexpr std::size_t class_count = 3;
+    static constexpr std::size_t class_sizes[class_count] = {256, 4096, 65536};
+    // Blocks kept per class on the free list; any more go back to the heap
+    static constexpr std::size_t max_cached = 32;
+
+    BufferPoolBlock* acquire(unsigned size_class) {
+        if (!m_free[size_class]) {
+            drain_returns();
+        }
+        BufferPoolBlock* block = m_free[size_class];
+        if (block) {
+            m_free[size_class] = block->next;
+            --m_cached[size_class];
+            return block;
+        }
+        void* memory = ::operator new(sizeof(BufferPoolBlock) + class_sizes[size_class],
+                                      std::align_val_t(alignof(BufferPoolBlock)), std::nothrow);
+        if (!memory) {
+            return nullptr;
+        }
+        m_refs.fetch_add(1, std::memory_order_relaxed);
+        live_blocks().fetch_add(1, std::memory_order_relaxed);
+        return new (memory) BufferPoolBlock{this, nullptr, size_class};
+    }
+
+    // Called by the owning thread
+    void release_local(BufferPoolBlock* block) noexcept {
+        unsigned size_class = block->size_class;
+        if (m_cached[size_class] >= max_cached) {
+            free_block(block);
+            return;
+        }
+        block->next = m_free[size_class];
+        m_free[size_class] = block;
+        ++m_cached[size_class];
+    }
+
+    // Called by any other thread
+    void release_remote(BufferPoolBlock* block) noexcept {
+        BufferPoolBlock* head = m_returns.load(std::memory_order_relaxed);
+        do {
+            if (head == closed()) {
+                free_block(block);
+                return;
+            }
+            block->next = head;
+        } while (!m_returns.compare_exchange_weak(head, block, std::memory_order_release,
+                                                  std::memory_order_relaxed));
+    }
+
+    // Thread exit: close the return list, free every cached block and drop
+    // the thread's reference
+    void close() noexcept {
+        BufferPoolBlock* returned = m_returns.exchange(closed(), std::memory_order_acquire);
+        free_list(returned);
+        for (std::size_t i = 0; i < class_count; ++i) {
+            free_list(m_free[i]);
+            m_free[i] = nullptr;
+            m_cached[i] = 0;
+        }
+        unref();
+    }
+
+    std::size_t cached(unsigned size_class) const noexcept {
+        return m_cached[size_class];
+    }
+
+    // Blocks from the heap not yet freed, over all threads; only the slow
+    // paths (heap allocation and free) touch it
+    static std::atomic<std::size_t>& live_blocks() noexcept {
+        static std::atomic<std::size_t> count{0};
+        return count;
+    }
+
+private:
+    static BufferPoolBlock* closed() noexcept {
+        return reinterpret_cast<BufferPoolBlock*>(std::uintptr_t(1));
+    }
+
+    // Move blocks returned by other threads onto the free lists
+    void drain_returns() noexcept {
+        BufferPoolBlock* block = m_returns.exchange(nullptr, std::memory_order_acquire);
+        while (block) {
+            BufferPoolBlock* next = block->next;
+            release_local(block);
+            block = next;
+        }
+    }
+
+    void free_list(BufferPoolBlock* block) noexcept {
+        while (block) {
+            BufferPoolBlock* next = block->next;
+            free_block(block);
+            block = next;
+        }
+    }
+
+    void free_block(BufferPoolBlock* block) noexcept {
+        block->~BufferPoolBlock();
+        ::operator delete(block, std::align_val_t(alignof(BufferPoolBlock)));
+        live_blocks().fetch_sub(1, std::memory_order_relaxed);
+        unref();
+    }
+
+    void unref() noexcept {
+        if (m_refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            delete this;
+        }
+    }
+
+    BufferPoolBlock* m_free[class_count] = {};
+    std::size_t m_cached[class_count] = {};
+    std::atomic<BufferPoolBlock*> m_returns{nullptr};
+    std::atomic<std::size_t> m_refs{1};
+};
+
+} // namespace detail
+
+/**
+ * A fixed-size block checked out of thread_buffer_pool, returned to the pool
+ * when destroyed. Move-only; may be moved to and destroyed on another thread.
+ * An empty pooled_buffer (data() == nullptr) means the request was larger
+ * than the largest size class or the heap was exhausted.
+ */
+class pooled_buffer {
+public:
+    pooled_buffer() noexcept = default;
+
+    pooled_buffer(pooled_buffer&& other) noexcept
+        : m_block(other.m_block) {
+        other.m_block = nullptr;
+    }
+
+    pooled_buffer& operator=(pooled_buffer&& other) noexcept {
+        if (this != &other) {
+            reset();
+            m_block = other.m_block;
+            other.m_block = nullptr;
+        }
+        return *this;
+    }
+
+    pooled_buffer(const pooled_buffer&) = delete;
+    pooled_buffer& operator=(const pooled_buffer&) = delete;
+
+    ~pooled_buffer() {
+        reset();
+    }
+
+    char* data() const noexcept {
+        return m_block ? m_block->data() : nullptr;
+    }
+
+    std::size_t size() const noexcept {
+        return m_block ? detail::BufferPoolCache::class_sizes[m_block->size_class] : 0;
+    }
+
+    explicit operator bool() const noexcept {
+        return m_block != nullptr;
+    }
+
+    /**
+     * Allocator backed by this block; the block must outlive its users
+     */
+    template <typename T = char, typename Overflow = NullOnOverflow>
+    FixedBufAllocator<T, Overflow> allocator() const noexcept {
+        return FixedBufAllocator<T, Overflow>(data(), size());
+    }
+
+    // Return the block to the pool now
+    void reset() noexcept;
+
+private:
+    friend class thread_buffer_pool;
+
+    explicit pooled_buffer(detail::BufferPoolBlock* block) noexcept
+        : m_block(block) {}
+
+    detail::BufferPoolBlock* m_block = nullptr;
+};
+
+/**
+ * Per-thread pools of fixed-size blocks (256 B, 4 KB and 64 KB) for backing
+ * stores that outlive a stack frame. Checkout and return on the owning thread
+ * touch only thread-local lists; a block released on another thread is
+ * pushed onto its owner's lock-free return list, so threads never contend
+ * on malloc or a shared lock.
+ *
+ *   pooled_buffer buf = thread_buffer_pool::acquire(1000);   // a 4 KB block
+ *   std::basic_string<char, std::char_traits<char>, FixedBufAllocator<char>> s(buf.allocator());
+ */
+class thread_buffer_pool {
+public:
+    static constexpr std::size_t small_size = detail::BufferPoolCache::class_sizes[0];
+    static constexpr std::size_t medium_size = detail::BufferPoolCache::class_sizes[1];
+    static constexpr std::size_t large_size = detail::BufferPoolCache::class_sizes[2];
+
+    // Check out the smallest block holding at least bytes
+    static pooled_buffer acquire(std::size_t bytes) {
+        for (unsigned i = 0; i < detail::BufferPoolCache::class_count; ++i) {
+            if (bytes <= detail::BufferPoolCache::class_sizes[i]) {
+                return pooled_buffer(cache().acquire(i));
+            }
+        }
+        return pooled_buffer();
+    }
+
+    // Blocks of the size class for bytes cached by the calling thread
+    static std::size_t cached(std::size_t bytes) noexcept {
+        detail::BufferPoolCache* local = holder().cache;
+        for (unsigned i = 0; i < detail::BufferPoolCache::class_count; ++i) {
+            if (bytes <= detail::BufferPoolCache::class_sizes[i]) {
+                return local ? local->cached(i) : 0;
+            }
+        }
+        return 0;
+    }
+
+    // Blocks allocated from the heap and not yet freed, checked out or
+    // cached, by every thread: what the pools hold on to
+    static std::size_t live_blocks() noexcept {
+        return detail::BufferPoolCache::live_blocks().load(std::memory_order_relaxed);
+    }
+
+private:
+    friend class pooled_buffer;
+
+    struct CacheHolder {
+        detail::BufferPoolCache* cache = nullptr;
+
+        ~CacheHolder() {
+            if (cache) {
+                cache->close();
+                cache = nullptr;
+            }
+        }
+    };
+
+    static CacheHolder& holder() noexcept {
+        thread_local CacheHolder h;
+        return h;
+    }
+
+    static detail::BufferPoolCache& cache() {
+        CacheHolder& h = holder();
+        if (!h.cache) {
+            h.cache = new detail::BufferPoolCache();
+        }
+        return *h.cache;
+    }
+
+    static void release(detail::BufferPoolBlock* block) noexcept {
+        if (block->owner == holder().cache) {
+            block->owner->release_local(block);
+        } else {
+            block->owner->release_remote(block);
+        }
+    }
+};
+
+inline void pooled_buffer::reset() noexcept {
+    if (m_block) {
+        thread_buffer_pool::release(m_block);
+        m_block = nullptr;
+    }
+}
+
+} // namespace stack_string
@@ -1,8 +1,15 @@
 #include <gtest/gtest.h>
 #include <fixed_buf_allocator.hpp>
 
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <sstream>
 #include <string>
 #include <cstring>
+#include <thread>
+#include <utility>
+#include <vector>
 
 using namespace stack_string;
 
@@ -29,3 +36,232 @@ TEST(FixedBufAllocatorTest, MultipleStringsDifferentBuffers) {
     EXPECT_EQ(s1, "foo");
     EXPECT_EQ(s2, "bar");
 }
+
+TEST(FixedBufAllocatorTest, LastBlockIsReclaimedAndExpandsInPlace) {
+    char buf[64];
+    FixedBufAllocator<char> alloc(buf, sizeof(buf));
+    char* a = alloc.allocate(8);
+    char* b = alloc.allocate(8);
+    EXPECT_EQ(alloc.used(), 16u);
+
+    alloc.deallocate(a, 8);  // not the last block: stays used
+    EXPECT_EQ(alloc.used(), 16u);
+    EXPECT_TRUE(alloc.expand(b, 8, 40));
+    EXPECT_EQ(alloc.used(), 48u);
+    EXPECT_FALSE(alloc.expand(b, 40, 64));
+    EXPECT_FALSE(alloc.expand(a, 8, 16));
+
+    alloc.deallocate(b, 40);
+    EXPECT_EQ(alloc.used(), 8u);
+    EXPECT_EQ(alloc.allocate(8), b);
+}
+
+TEST(FixedBufAllocatorTest, StringRegrowthOnlyReclaimsLifoFrees) {
+    using String = std::basic_string<char, std::char_traits<char>, FixedBufAllocator<char>>;
+    char buf[256];
+    String grown{FixedBufAllocator<char>(buf, sizeof(buf))};
+    grown.append(50, 'x');
+    grown.append(50, 'y');  // The new block comes before the old one is freed
+    EXPECT_GT(grown.get_allocator().used(), grown.capacity() + 1);
+
+    String reserved{FixedBufAllocator<char>(buf, sizeof(buf))};
+    reserved.reserve(100);
+    reserved.append(50, 'x');
+    reserved.append(50, 'y');
+    EXPECT_EQ(reserved.get_allocator().used(), reserved.capacity() + 1);
+}
+
+TEST(FixedBufAllocatorTest, MarkRewindAndReset) {
+    char buf[64];
+    FixedBufAllocator<char> alloc(buf, sizeof(buf));
+    alloc.allocate(16);
+    std::size_t request = alloc.mark();
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_EQ(alloc.allocate(48), buf + 16);
+        EXPECT_EQ(alloc.allocate(1), nullptr);
+        alloc.rewind(request);
+    }
+    alloc.reset();
+    EXPECT_EQ(alloc.used(), 0u);
+    EXPECT_EQ(alloc.allocate(64), buf);
+}
+
+TEST(FixedBufAllocatorTest, ArenaIsSharedByContainers) {
+    alignas(std::max_align_t) char buf[4096];
+    FixedBufArena arena(buf, sizeof(buf));
+    using ArenaString = std::basic_string<char, std::char_traits<char>, ArenaAllocator<char>>;
+
+    ArenaString s(arena);
+    std::vector<int, ArenaAllocator<int>> v(arena);
+    std::map<int, int, std::less<int>, ArenaAllocator<std::pair<const int, int>>> m(arena);
+    s.assign(100, 's');
+    for (int i = 0; i < 50; ++i) {
+        v.push_back(i);
+        m.emplace(i, i);
+    }
+    // Every allocation came from one usage count, so nothing overlaps
+    EXPECT_EQ(s.find_first_not_of('s'), ArenaString::npos);
+    EXPECT_EQ(s.size(), 100u);
+    for (int i = 0; i < 50; ++i) {
+        EXPECT_EQ(v[i], i);
+        EXPECT_EQ(m.at(i), i);
+    }
+    EXPECT_GT(arena.used(), 100 + 50 * sizeof(int));
+    EXPECT_EQ(ArenaAllocator<char>(arena), v.get_allocator());
+}
+
+TEST(FixedBufAllocatorTest, OverflowPolicies) {
+    char buf[64];
+    FixedBufAllocator<char, UpstreamOnOverflow<>> alloc(buf, sizeof(buf));
+    using FallbackString = std::basic_string<char, std::char_traits<char>, decltype(alloc)>;
+    FallbackString s(alloc);
+    s.assign(40, 'a');
+    EXPECT_EQ(s.get_allocator().overflow_count(), 0u);
+    s.append(200, 'b');  // too large for what is left: served by the heap
+    EXPECT_EQ(s.size(), 240u);
+    EXPECT_EQ(s.get_allocator().overflow_count(), 1u);
+
+    FixedBufAllocator<int, ThrowOnOverflow> strict(buf, sizeof(buf));
+    EXPECT_NE(strict.allocate(8), nullptr);
+    EXPECT_THROW(strict.allocate(64), std::bad_alloc);
+
+    FixedBufAllocator<int> quiet(buf, sizeof(buf));
+    EXPECT_EQ(quiet.allocate(64), nullptr);
+    EXPECT_EQ(quiet.overflow_count(), 1u);
+}
+
+TEST(FixedBufAllocatorTest, BlocksAreAlignedForTheirType) {
+    alignas(64) char buf[512];
+    FixedBufAllocator<char> chars(buf, sizeof(buf));
+    EXPECT_EQ(chars.allocate(3), buf);
+
+    FixedBufAllocator<std::uint64_t> words(chars);  // rebind continues at offset 3
+    std::uint64_t* w = words.allocate(2);
+    EXPECT_EQ(reinterpret_cast<char*>(w), buf + 8);
+    EXPECT_EQ(words.used(), 24u);
+
+    std::uint64_t* line = words.allocate(4, 64);
+    EXPECT_EQ(reinterpret_cast<char*>(line), buf + 64);
+    words.deallocate(line, 4, 64);
+    EXPECT_EQ(words.used(), 64u);
+
+    std::map<int, double, std::less<int>, FixedBufAllocator<std::pair<const int, double>>>
+        m(FixedBufAllocator<std::pair<const int, double>>(buf, sizeof(buf)));
+    for (int i = 0; i < 8; ++i) {
+        auto it = m.emplace(i, i * 0.5).first;
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(&it->second) % alignof(double), 0u);
+    }
+}
+
+// Built a second time with STACK_STRING_ALLOCATOR_STATS (see CMakeLists.txt)
+TEST(FixedBufAllocatorTest, StatsAreRecordedPerTag) {
+    static allocator_stats_tag tag("stats_test");
+    char buf[64];
+    FixedBufAllocator<char> alloc(buf, sizeof(buf), tag);
+    char* a = alloc.allocate(16);
+    alloc.allocate(8);
+    alloc.deallocate(a, 16);  // not the last block: wasted
+    EXPECT_EQ(alloc.allocate(64), nullptr);
+
+    allocator_stats s = alloc.stats();
+    allocator_stats t = tag.stats();
+    if (!allocator_stats_enabled) {
+        EXPECT_EQ(s.allocations, 0u);
+        EXPECT_EQ(t.allocations, 0u);
+        return;
+    }
+    EXPECT_EQ(s.bytes_requested, 24u);
+    EXPECT_EQ(s.allocations, 2u);
+    EXPECT_EQ(s.peak_used, 24u);
+    EXPECT_EQ(s.wasted_bytes, 16u);
+    EXPECT_EQ(s.overflows, 1u);
+    EXPECT_EQ(t.bytes_requested, 24u);
+    EXPECT_EQ(t.overflows, 1u);
+
+    bool found = false;
+    for_each_allocator_tag([&](const allocator_stats_tag& entry) {
+        found = found || &entry == &tag;
+    });
+    EXPECT_TRUE(found);
+
+    FixedBufArena arena(buf, sizeof(buf), STACK_STRING_ALLOCATOR_TAG("stats_arena"));
+    arena.allocate(32);
+    EXPECT_EQ(arena.stats().peak_used, 32u);
+}
+
+namespace {
+
+template <int I>
+allocator_stats_tag& race_tag() {
+    static allocator_stats_tag tag("race_tag");
+    return tag;
+}
+
+template <int... I>
+std::vector<allocator_stats_tag*> register_tags_concurrently(std::integer_sequence<int, I...>) {
+    std::vector<allocator_stats_tag*> tags(sizeof...(I));
+    std::thread threads[] = {std::thread([&tags] { tags[I] = &race_tag<I>(); })...};
+    for (std::thread& t : threads) {
+        t.join();
+    }
+    return tags;
+}
+
+} // namespace
+
+TEST(FixedBufAllocatorTest, TagsRegisterFromManyThreads) {
+    std::vector<allocator_stats_tag*> tags = register_tags_concurrently(std::make_integer_sequence<int, 16>{});
+    std::size_t found = 0;
+    for_each_allocator_tag([&](const allocator_stats_tag& entry) {
+        for (allocator_stats_tag* tag : tags) {
+            found += &entry == tag;
+        }
+    });
+    EXPECT_EQ(found, tags.size());
+}
+
+TEST(FixedBufAllocatorTest, BufferStringReservesItsWholeBuffer) {
+    BufferString<100> s("key:");
+    EXPECT_GE(s.capacity(), 99u);
+    const char* data = s.data();
+    s.append(95, 'x');
+    EXPECT_EQ(s.data(), data);  // No reallocation up to capacity
+    EXPECT_EQ(s.size(), 99u);
+    EXPECT_EQ(s.get_allocator().overflow_count(), 0u);
+
+    BufferString<100> copy(s);
+    EXPECT_NE(copy.data(), s.data());
+    EXPECT_EQ(copy.view(), s.view());
+    BufferString<100> other("other");
+    swap(copy, other);
+    EXPECT_EQ(copy, "other");
+    EXPECT_EQ(other.view(), s.view());
+
+    BufferString<20> small;
+    EXPECT_GE(small.capacity(), 19u);
+    small = "fits in the buffer";
+    EXPECT_EQ(small.view(), "fits in the buffer");
+    EXPECT_EQ(sizeof(BufferString<256>), 256 + sizeof(BufferString<256>::string_type));
+}
+
+TEST(FixedBufAllocatorTest, BufferStringKeepsItsAllocator) {
+    // The base string is out of reach, so a = b cannot propagate b's allocator
+    static_assert(!std::is_convertible_v<BufferString<32>&, BufferString<32>::string_type&>);
+
+    BufferString<64> a("first");
+    const char* data = a.data();
+    auto b = std::make_unique<BufferString<64>>("second, and longer");
+    a = *b;
+    a.append(*b).assign(*b, 0, 6);
+    a += *b;
+    b.reset();
+    EXPECT_EQ(a.data(), data);
+    EXPECT_EQ(a, "secondsecond, and longer");
+    a.erase(0, 6).insert(0, "first ").replace(0, 5, "1st");
+    EXPECT_EQ(a.view(), "1st second, and longer");
+    EXPECT_EQ(a.get_allocator().overflow_count(), 0u);
+
+    std::ostringstream out;
+    out << a;
+    EXPECT_EQ(out.str(), a.view());
+}
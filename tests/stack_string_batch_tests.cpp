@@ -0,0 +1,70 @@
+#include <gtest/gtest.h>
+#include <stack_string_batch.hpp>
+#include <fixed_buf_allocator.hpp>
+
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+using namespace stack_string;
+
+namespace {
+
+// Read everything written to the pipe so far
+std::string drain(int fd, std::size_t bytes) {
+    std::string out(bytes, '\0');
+    std::size_t got = 0;
+    while (got < bytes) {
+        ssize_t n = ::read(fd, &out[got], bytes - got);
+        if (n <= 0) break;
+        got += static_cast<std::size_t>(n);
+    }
+    out.resize(got);
+    return out;
+}
+
+} // namespace
+
+TEST(StringBatchTest, GathersStringsWithoutCopying) {
+    StackString<32> header("GET /index HTTP/1.1\r\n");
+    BufferString<64> host("Host: example.com\r\n");
+    StackString<8> empty;
+
+    string_batch<4> batch;
+    EXPECT_TRUE(batch.add_all(header, host.view(), empty, "\r\n"));
+    EXPECT_EQ(batch.size(), 3u);
+    EXPECT_EQ(batch.data()[0].iov_base, header.data());
+    EXPECT_EQ(batch.bytes(), header.size() + host.size() + 2);
+
+    // Adjacent pieces of one string share a segment
+    std::string_view text = "abcdef";
+    EXPECT_TRUE(batch.add(text.substr(0, 3)));
+    EXPECT_TRUE(batch.add(text.substr(3)));
+    EXPECT_EQ(batch.size(), 4u);
+    EXPECT_TRUE(batch.full());
+    EXPECT_FALSE(batch.add("x"));
+
+    int fds[2];
+    ASSERT_EQ(::pipe(fds), 0);
+    std::size_t bytes = batch.bytes();
+    EXPECT_EQ(write_all(fds[1], batch), std::errc());
+    EXPECT_TRUE(batch.empty());
+    EXPECT_EQ(drain(fds[0], bytes), "GET /index HTTP/1.1\r\nHost: example.com\r\n\r\nabcdef");
+
+    // More segments than one writev() accepts
+    std::vector<StackString<4>> parts(2000, StackString<4>("ab"));
+    std::vector<iovec> iov;
+    for (auto& p : parts) {
+        iov.push_back(iovec{p.data(), p.size()});
+    }
+    EXPECT_EQ(write_all(fds[1], iov.data(), iov.size()), std::errc());
+    EXPECT_EQ(drain(fds[0], 4000).size(), 4000u);
+
+    ::close(fds[0]);
+    EXPECT_EQ(write_all(fds[1], iov.data(), 0), std::errc());
+    ::close(fds[1]);
+    string_batch<> closed;
+    closed.add("x");
+    EXPECT_EQ(write_all(fds[1], closed), std::errc::bad_file_descriptor);
+}
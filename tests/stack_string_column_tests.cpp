@@ -0,0 +1,186 @@
+#include <gtest/gtest.h>
+#include <stack_string_column.hpp>
+#include <fixed_buf_allocator.hpp>
+
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+using namespace stack_string;
+
+namespace {
+
+template <std::size_t N>
+column<N> make_column(const std::vector<std::string>& texts) {
+    column<N> c;
+    for (const std::string& t : texts) {
+        EXPECT_TRUE(c.push_back(t));
+    }
+    return c;
+}
+
+// Shared by every rebound second_call_throws
+struct allocation_counts {
+    static inline int calls = 0;
+    static inline long long live = 0;
+};
+
+// std::allocator that throws on its second allocation and counts the
+// bytes it has handed out
+template <typename T>
+struct second_call_throws {
+    using value_type = T;
+
+    second_call_throws() noexcept = default;
+
+    template <typename U>
+    second_call_throws(const second_call_throws<U>&) noexcept {}
+
+    T* allocate(std::size_t n) {
+        if (++allocation_counts::calls == 2) {
+            throw std::bad_alloc();
+        }
+        allocation_counts::live += static_cast<long long>(n * sizeof(T));
+        return std::allocator<T>().allocate(n);
+    }
+
+    void deallocate(T* p, std::size_t n) noexcept {
+        allocation_counts::live -= static_cast<long long>(n * sizeof(T));
+        std::allocator<T>().deallocate(p, n);
+    }
+
+    template <typename U>
+    bool operator==(const second_call_throws<U>&) const noexcept { return true; }
+    template <typename U>
+    bool operator!=(const second_call_throws<U>&) const noexcept { return false; }
+};
+
+} // namespace
+
+TEST(ColumnTest, StoresRowsZeroPadded) {
+    column<8> c;
+    EXPECT_TRUE(c.empty());
+    EXPECT_TRUE(c.push_back("AAPL"));
+    EXPECT_TRUE(c.push_back(StackString<16>("12345678")));  // Exactly N characters
+    EXPECT_FALSE(c.push_back("123456789"));
+    ASSERT_EQ(c.size(), 2u);
+    EXPECT_EQ(c[0], "AAPL");
+    EXPECT_EQ(c[1], "12345678");
+    EXPECT_EQ(c.lengths()[0], 4u);
+    EXPECT_EQ(std::string(c.row(0), 8), std::string("AAPL\0\0\0\0", 8));
+
+    EXPECT_TRUE(c.set(1, "MS"));
+    EXPECT_EQ(std::string(c.row(1), 8), std::string("MS\0\0\0\0\0\0", 8));
+
+    column<8> copy(c);
+    EXPECT_EQ(copy[1], "MS");
+    column<8> moved(std::move(copy));
+    EXPECT_EQ(moved.size(), 2u);
+    EXPECT_TRUE(copy.empty());
+    c.clear();
+    EXPECT_TRUE(c.empty());
+}
+
+TEST(ColumnTest, EqualityAndPrefixScans) {
+    // 40-character rows take more than one SIMD block
+    std::vector<std::string> texts;
+    for (int i = 0; i < 200; ++i) {
+        texts.push_back(i % 3 == 0 ? "order-" + std::to_string(i) : "fill-" + std::to_string(i % 7));
+    }
+    texts.push_back(std::string(40, 'x'));
+    column<40> c = make_column<40>(texts);
+
+    std::vector<std::uint32_t> out(c.size());
+    std::size_t n = c.select_equal("fill-3", out.data());
+    std::vector<std::uint32_t> expected;
+    for (std::uint32_t i = 0; i < texts.size(); ++i) {
+        if (texts[i] == "fill-3") expected.push_back(i);
+    }
+    EXPECT_EQ(std::vector<std::uint32_t>(out.begin(), out.begin() + n), expected);
+    EXPECT_EQ(c.count_equal("fill-3"), expected.size());
+    EXPECT_EQ(c.count_equal("fill-"), 0u);  // Equal bytes, different length
+    EXPECT_EQ(c.count_equal(std::string(40, 'x')), 1u);
+    EXPECT_EQ(c.count_equal(std::string(41, 'x')), 0u);
+
+    std::vector<std::uint64_t> bitmap((c.size() + 63) / 64, ~std::uint64_t(0));
+    c.mask_prefix("order-", bitmap.data());
+    for (std::size_t i = 0; i < texts.size(); ++i) {
+        bool set = (bitmap[i / 64] >> (i % 64)) & 1;
+        EXPECT_EQ(set, texts[i].rfind("order-", 0) == 0) << i;
+    }
+    EXPECT_EQ(bitmap.back() >> (c.size() % 64), 0u);  // Bits past the end are clear
+
+    n = c.select_prefix("", out.data());
+    EXPECT_EQ(n, c.size());
+    c.mask_equal("nothing", bitmap.data());
+    for (std::uint64_t word : bitmap) {
+        EXPECT_EQ(word, 0u);
+    }
+}
+
+TEST(ColumnTest, HashesMatchStringHash) {
+    column<16> c = make_column<16>({"", "a", "sixteen chars!!!", "symbol"});
+    std::uint64_t hashes[4];
+    c.hash_rows(hashes, 7);
+    for (std::size_t i = 0; i < c.size(); ++i) {
+        EXPECT_EQ(hashes[i], hash(c[i], 7));
+    }
+}
+
+TEST(ColumnTest, ReportsAllocationFailure) {
+    alignas(16) char buffer[512];
+    FixedBufArena arena(buffer, sizeof(buffer));
+    column<16, ArenaAllocator<char>> c{ArenaAllocator<char>(arena)};
+    std::size_t pushed = 0;
+    while (c.push_back("row") && pushed < 1000) {
+        ++pushed;
+    }
+    EXPECT_GT(pushed, 0u);
+    EXPECT_LT(pushed, 1000u);
+    EXPECT_EQ(c.size(), pushed);
+    EXPECT_EQ(c[pushed - 1], "row");
+}
+
+TEST(ColumnTest, CopiesThrowOnFailureAndPropagateAllocators) {
+    alignas(16) char first[512];
+    alignas(16) char second[512];
+    FixedBufArena arena1(first, sizeof(first));
+    FixedBufArena arena2(second, sizeof(second));
+    using col = column<16, ArenaAllocator<char>>;
+    col a{ArenaAllocator<char>(arena1)};
+    col b{ArenaAllocator<char>(arena2)};
+    ASSERT_TRUE(a.push_back("old"));
+    ASSERT_TRUE(b.reserve(8));
+    ASSERT_TRUE(b.push_back("new"));
+
+    a = b;  // ArenaAllocator propagates on copy assignment
+    EXPECT_TRUE(a.get_allocator() == ArenaAllocator<char>(arena2));
+    EXPECT_EQ(a.size(), 1u);
+    EXPECT_EQ(a[0], "new");
+
+    // Rows filling over half the arena cannot be copied within it
+    alignas(16) char third[512];
+    FixedBufArena arena3(third, sizeof(third));
+    col big{ArenaAllocator<char>(arena3)};
+    ASSERT_TRUE(big.reserve(20));
+    for (int i = 0; i < 20; ++i) {
+        ASSERT_TRUE(big.push_back("big"));
+    }
+    EXPECT_THROW(col copy(big), std::bad_alloc);
+    col target{ArenaAllocator<char>(arena3)};
+    EXPECT_THROW(target = big, std::bad_alloc);
+    EXPECT_TRUE(target.empty());
+}
+
+TEST(ColumnTest, ThrowingAllocatorLeavesNothingAllocated) {
+    {
+        column<16, second_call_throws<char>> c;
+        EXPECT_THROW(c.reserve(8), std::bad_alloc);  // The lengths allocation throws
+        EXPECT_EQ(allocation_counts::live, 0);
+        EXPECT_EQ(c.capacity(), 0u);
+        ASSERT_TRUE(c.reserve(8));
+        ASSERT_TRUE(c.push_back("row"));
+    }
+    EXPECT_EQ(allocation_counts::live, 0);
+}
@@ -0,0 +1,187 @@
+#include <gtest/gtest.h>
+#include <stack_string_flat_map.hpp>
+#include <fixed_buf_allocator.hpp>
+
+#include <map>
+#include <memory>
+#include <new>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+using namespace stack_string;
+
+namespace {
+
+// Allocator that counts the bytes live under each id, so a block freed
+// through the wrong allocator shows up as a negative count
+template <typename T, bool Propagate>
+struct tagged_allocator {
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::bool_constant<Propagate>;
+    using propagate_on_container_move_assignment = std::bool_constant<Propagate>;
+    using propagate_on_container_swap = std::bool_constant<Propagate>;
+
+    template <typename U>
+    struct rebind {
+        using other = tagged_allocator<U, Propagate>;
+    };
+
+    static long long* live() {
+        static long long bytes[4] = {};
+        return bytes;
+    }
+
+    explicit tagged_allocator(int id) noexcept : id(id) {}
+
+    template <typename U>
+    tagged_allocator(const tagged_allocator<U, Propagate>& other) noexcept : id(other.id) {}
+
+    T* allocate(std::size_t n) {
+        live()[id] += static_cast<long long>(n * sizeof(T));
+        return std::allocator<T>().allocate(n);
+    }
+
+    void deallocate(T* p, std::size_t n) noexcept {
+        live()[id] -= static_cast<long long>(n * sizeof(T));
+        std::allocator<T>().deallocate(p, n);
+    }
+
+    template <typename U>
+    bool operator==(const tagged_allocator<U, Propagate>& other) const noexcept { return id == other.id; }
+    template <typename U>
+    bool operator!=(const tagged_allocator<U, Propagate>& other) const noexcept { return id != other.id; }
+
+    int id;
+};
+
+template <bool Propagate>
+void check_assignment_follows_traits() {
+    using alloc = tagged_allocator<std::pair<const StackString<16>, int>, Propagate>;
+    using map = flat_map<StackString<16>, int, alloc>;
+    {
+        map a{alloc(1)}, b{alloc(2)};
+        a.try_emplace("old", 0);
+        for (int i = 0; i < 40; ++i) {
+            b.try_emplace(StackString<16>("k", i), i);
+        }
+
+        a = b;
+        EXPECT_EQ(a.get_allocator().id, Propagate ? 2 : 1);
+        EXPECT_EQ(a.size(), 40u);
+        EXPECT_EQ(a.find("k7")->second, 7);
+        EXPECT_EQ(a.find("old"), a.end());
+
+        map c{alloc(3)};
+        c = std::move(a);
+        EXPECT_EQ(c.get_allocator().id, Propagate ? 2 : 3);
+        EXPECT_EQ(c.size(), 40u);
+        EXPECT_EQ(c.find("k39")->second, 39);
+
+        map d{alloc(3)};
+        d.try_emplace("d", 1);
+        c.swap(d);
+        EXPECT_EQ(d.size(), 40u);
+        EXPECT_EQ(c.find("d")->second, 1);
+    }
+    for (int id = 0; id < 4; ++id) {
+        EXPECT_EQ(alloc::live()[id], 0) << "allocator " << id;
+    }
+}
+
+} // namespace
+
+TEST(FlatMapTest, InsertFindAndHeterogeneousLookup) {
+    flat_map<StackString<16>, int> m;
+    EXPECT_TRUE(m.try_emplace("AAPL", 1).second);
+    EXPECT_TRUE(m.insert({"MSFT", 2}).second);
+    EXPECT_FALSE(m.try_emplace("AAPL", 3).second);
+    EXPECT_EQ(m.size(), 2u);
+
+    EXPECT_EQ(m.find("AAPL")->second, 1);
+    EXPECT_EQ(m.find(std::string_view("MSFT"))->second, 2);
+    EXPECT_EQ(m.find(StackString<64>("MSFT"))->second, 2);
+    EXPECT_EQ(m.find(StackString<4>("IBM")), m.end());
+    EXPECT_FALSE(m.contains("a key longer than any stored key"));
+
+    m.insert_or_assign("AAPL", 10);
+    EXPECT_EQ(m.find("AAPL")->second, 10);
+}
+
+TEST(FlatMapTest, GrowEraseAndIterateMatchReference) {
+    flat_map<StackString<24>, int> m;
+    std::map<std::string, int> expected;
+    for (int i = 0; i < 1000; ++i) {
+        StackString<24> key("sym", i);
+        m.try_emplace(key, i);
+        expected.emplace(std::string(key.c_str()), i);
+    }
+    for (int i = 0; i < 1000; i += 3) {
+        StackString<24> key("sym", i);
+        EXPECT_EQ(m.erase(key), 1u);
+        expected.erase(std::string(key.c_str()));
+    }
+    // Churn through tombstones without growing past the live size
+    for (int round = 0; round < 5; ++round) {
+        for (int i = 0; i < 1000; i += 3) {
+            m.try_emplace(StackString<24>("tmp", i), i);
+        }
+        for (int i = 0; i < 1000; i += 3) {
+            m.erase(StackString<24>("tmp", i));
+        }
+    }
+    EXPECT_EQ(m.size(), expected.size());
+
+    std::map<std::string, int> seen;
+    for (const auto& [key, value] : m) {
+        seen.emplace(std::string(key.c_str()), value);
+    }
+    EXPECT_EQ(seen, expected);
+
+    flat_map<StackString<24>, int> copy = m;
+    EXPECT_EQ(copy.size(), m.size());
+    EXPECT_EQ(copy.find("sym1")->second, 1);
+    EXPECT_EQ(copy.find("sym3"), copy.end());
+}
+
+TEST(FlatMapTest, AllocationFailureIsReported) {
+    alignas(std::max_align_t) char buffer[4096];
+    FixedBufAllocator<std::pair<const StackString<16>, int>> alloc(buffer, sizeof(buffer));
+    flat_map<StackString<16>, int, decltype(alloc)> m(alloc);
+
+    int inserted = 0;
+    for (int i = 0; i < 1000; ++i) {
+        auto [it, ok] = m.try_emplace(StackString<16>("k", i), i);
+        if (!ok) {
+            EXPECT_EQ(it, m.end());
+            break;
+        }
+        ++inserted;
+    }
+    EXPECT_GT(inserted, 0);
+    EXPECT_LT(inserted, 1000);
+    EXPECT_EQ(m.size(), static_cast<std::size_t>(inserted));
+    EXPECT_EQ(m.find(StackString<16>("k", 0))->second, 0);
+}
+
+TEST(FlatMapTest, CopyThatCannotAllocateThrows) {
+    alignas(std::max_align_t) char buffer[4096];
+    FixedBufAllocator<std::pair<const StackString<16>, int>> alloc(buffer, sizeof(buffer));
+    using map = flat_map<StackString<16>, int, decltype(alloc)>;
+    map m(alloc);
+    for (int i = 0; m.try_emplace(StackString<16>("k", i), i).second; ++i) {
+    }
+    // The buffer holds the table and the blocks its growth left behind, so
+    // there is no room for a second table
+    EXPECT_THROW(map copy(m), std::bad_alloc);
+
+    map target(alloc);
+    EXPECT_THROW(target = m, std::bad_alloc);
+    EXPECT_TRUE(target.empty());
+}
+
+TEST(FlatMapTest, AssignmentPropagatesAllocatorsAsTheirTraitsSay) {
+    check_assignment_follows_traits<true>();
+    check_assignment_follows_traits<false>();
+}
@@ -0,0 +1,100 @@
+#include <gtest/gtest.h>
+#include <stack_string_format.hpp>
+
+#include <cstdint>
+#include <limits>
+#include <string_view>
+
+using namespace stack_string;
+
+TEST(StackStringFormatTest, PositionalArguments) {
+    auto s = format<64>(STACK_STRING_FMT("{}:{} {}"), "AAPL", 42, 1.5);
+    EXPECT_EQ(s, "AAPL:42 1.5");
+}
+
+TEST(StackStringFormatTest, EscapedBraces) {
+    auto s = format<32>(STACK_STRING_FMT("{{{}}}"), 7);
+    EXPECT_EQ(s, "{7}");
+}
+
+TEST(StackStringFormatTest, WidthFillAndBases) {
+    auto s = format<64>(STACK_STRING_FMT("[{:>5}][{:<4}][{:*^7}][{:06}]"), 42, "ab", "mid", -42);
+    EXPECT_EQ(s, "[   42][ab  ][**mid**][-00042]");
+
+    auto h = format<64>(STACK_STRING_FMT("{:x} {:08X} {:o} {:b}"), 255, 0xBEEFu, 8, 5);
+    EXPECT_EQ(h, "ff 0000BEEF 10 101");
+}
+
+TEST(StackStringFormatTest, FloatingPointPrecision) {
+    auto s = format<64>(STACK_STRING_FMT("{:.2f} {:.1e} {:8.3f}"), 3.14159, 1234.5, 2.0);
+    EXPECT_EQ(s, "3.14 1.2e+03    2.000");
+}
+
+TEST(StackStringFormatTest, AppendsAndTruncatesLikeAppend) {
+    StackString<8> s("ab");
+    format_to(s, STACK_STRING_FMT("{}-{}"), "cdefgh", 1);
+    EXPECT_EQ(s, "abcdefg");
+}
+
+TEST(StackStringFormatTest, BoolAndCharArguments) {
+    auto b = format<64>(STACK_STRING_FMT("{} {:s} [{:>6}] {:d} {:#x}"), true, false, true, true, false);
+    EXPECT_EQ(b, "true false [  true] 1 0x0");
+
+    auto c = format<32>(STACK_STRING_FMT("{}{:c}[{:3}][{:>3}][{:*^5}]"), 'a', 'b', 'c', 'd', 'e');
+    EXPECT_EQ(c, "ab[c  ][  d][**e**]");
+}
+
+TEST(StackStringFormatTest, SignFlags) {
+    auto s = format<64>(STACK_STRING_FMT("{:+} {:+} {: } {: } {:-} {:+}"), 5, -5, 5, -5, 5, 0u);
+    EXPECT_EQ(s, "+5 -5  5 -5 5 +0");
+
+    auto z = format<64>(STACK_STRING_FMT("[{:+06}][{: 06}][{:+6}][{:<+6}]"), 42, 42, 42, 42);
+    EXPECT_EQ(z, "[+00042][ 00042][   +42][+42   ]");
+
+    auto f = format<64>(STACK_STRING_FMT("{:+.1f} {: .1f} {:+.1f} {:+08.2f}"), 1.25, 1.25, -1.25, 3.5);
+    EXPECT_EQ(f, "+1.2  1.2 -1.2 +0003.50");
+}
+
+TEST(StackStringFormatTest, AlternatePrefixes) {
+    auto s = format<64>(STACK_STRING_FMT("{:#x} {:#X} {:#o} {:#o} {:#b} {:#d}"), 255, 255, 8, 0, 5, 7);
+    EXPECT_EQ(s, "0xff 0XFF 010 0 0b101 7");
+
+    auto z = format<64>(STACK_STRING_FMT("[{:#010x}][{:#10x}][{:+#x}][{:#x}]"), 0xbeef, 0xbeef, 1, -31);
+    EXPECT_EQ(z, "[0x0000beef][    0xbeef][+0x1][-0x1f]");
+
+    auto m = format<32>(STACK_STRING_FMT("{:#b}"), std::numeric_limits<std::int8_t>::min());
+    EXPECT_EQ(m, "-0b10000000");
+}
+
+TEST(StackStringFormatTest, WidthBeyondCapacity) {
+    // Padding is cut at the capacity; right alignment still keeps the text
+    auto right = format<8>(STACK_STRING_FMT("{:>20}"), "ab");
+    EXPECT_EQ(right, "     ab");
+    auto left = format<8>(STACK_STRING_FMT("{:<20}|"), "ab");
+    EXPECT_EQ(left, "ab     ");
+    auto number = format<8>(STACK_STRING_FMT("{:020}"), -12);
+    EXPECT_EQ(number, "-000012");
+
+    // Fill with truncation: the fill that fits is split as for a wider field
+    auto centre = format<6>(STACK_STRING_FMT("{:*^10}"), "ab");
+    EXPECT_EQ(centre, "*ab**");
+    StackString<8> s("abcd");
+    format_to(s, STACK_STRING_FMT("{:-^9}"), "xy");  // One fill left: it goes right
+    EXPECT_EQ(s, "abcdxy-");
+}
+
+TEST(StackStringFormatTest, NumbersThatDoNotFitAreDropped) {
+    StackString<8, Options::TrackTruncation> s("abcd");
+    format_to(s, STACK_STRING_FMT("{:#x}"), 0xfff);  // "0xfff" needs 5
+    EXPECT_EQ(s, "abcd");
+    EXPECT_TRUE(s.truncated());
+
+    StackString<8, Options::TrackTruncation> t("abcdef");
+    format_to(t, STACK_STRING_FMT("{:+}"), 12);  // Sign fits, digits do not
+    EXPECT_EQ(t, "abcdef");
+    EXPECT_TRUE(t.truncated());
+
+    StackString<8> u("abcde");
+    format_to(u, STACK_STRING_FMT("{:+}"), 1);
+    EXPECT_EQ(u, "abcde+1");
+}
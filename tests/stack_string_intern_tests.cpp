@@ -0,0 +1,84 @@
+#include <gtest/gtest.h>
+#include <stack_string_intern.hpp>
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace stack_string;
+
+TEST(InternTableTest, SameTextSameHandle) {
+    intern_table<16> table;
+    EXPECT_TRUE(table.empty());
+    EXPECT_FALSE(table.find("AAPL"));
+
+    intern_handle aapl = table.intern("AAPL");
+    intern_handle msft = table.intern(StackString<8>("MSFT"));
+    ASSERT_TRUE(aapl);
+    ASSERT_TRUE(msft);
+    EXPECT_NE(aapl, msft);
+    EXPECT_EQ(table.intern(std::string("AAPL")), aapl);
+    EXPECT_EQ(table.find("MSFT"), msft);
+    EXPECT_EQ(table.size(), 2u);
+
+    EXPECT_EQ(table.view(aapl), "AAPL");
+    EXPECT_EQ(table.str(msft), StackString<16>("MSFT"));
+    intern_handle empty = table.intern("");
+    EXPECT_EQ(table.find(""), empty);
+
+    // Too long to store: rejected rather than truncated
+    EXPECT_FALSE(table.intern("sixteen chars!!!"));
+    EXPECT_TRUE(table.intern("fifteen chars!!"));
+    EXPECT_FALSE(intern_handle());
+}
+
+TEST(InternTableTest, BatchInsertAcrossSegments) {
+    intern_table<24> table;
+    std::vector<std::string> texts;
+    for (int i = 0; i < 5000; ++i) {
+        texts.push_back("symbol-" + std::to_string(i));
+    }
+    texts.push_back("symbol-17");  // Duplicate within the batch
+
+    std::vector<intern_handle> handles(texts.size());
+    ASSERT_EQ(table.intern(texts.data(), texts.size(), handles.data()), texts.size());
+    EXPECT_EQ(table.size(), 5000u);
+    EXPECT_EQ(handles.back(), handles[17]);
+    for (std::size_t i = 0; i < 5000; ++i) {
+        EXPECT_EQ(handles[i].value(), i);  // Insertion order
+        EXPECT_EQ(table.view(handles[i]), texts[i]);
+        EXPECT_EQ(table.find(texts[i]), handles[i]);
+    }
+}
+
+TEST(InternTableTest, LockFreeReadsDuringInsertion) {
+    constexpr int count = 20000;
+    intern_table<16> table;
+    std::atomic<bool> done{false};
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 3; ++r) {
+        readers.emplace_back([&] {
+            while (!done.load(std::memory_order_acquire)) {
+                std::size_t n = table.size();
+                for (std::size_t i = 0; i < n; i += 97) {
+                    StackString<16> expected;
+                    expected << 'k' << i;
+                    intern_handle h = table.find(expected);
+                    ASSERT_TRUE(h);
+                    ASSERT_EQ(table.view(h), expected);
+                }
+            }
+        });
+    }
+    for (int i = 0; i < count; ++i) {
+        StackString<16> key;
+        key << 'k' << i;
+        ASSERT_TRUE(table.intern(key));
+    }
+    done.store(true, std::memory_order_release);
+    for (auto& t : readers) {
+        t.join();
+    }
+    EXPECT_EQ(table.size(), static_cast<std::size_t>(count));
+}
@@ -0,0 +1,243 @@
+#include <gtest/gtest.h>
+#include <stack_string_log.hpp>
+
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace stack_string;
+
+namespace {
+
+// Collects everything written to a pipe on its own thread, so a logger
+// writing more than the pipe holds never stalls a test
+class pipe_reader {
+public:
+    pipe_reader() {
+        int fds[2];
+        EXPECT_EQ(::pipe(fds), 0);
+        m_read = fds[0];
+        m_write = fds[1];
+        m_thread = std::thread([this] {
+            char buf[4096];
+            ssize_t n;
+            while ((n = ::read(m_read, buf, sizeof(buf))) > 0) {
+                m_text.append(buf, static_cast<std::size_t>(n));
+            }
+        });
+    }
+
+    ~pipe_reader() {
+        if (m_thread.joinable()) {
+            finish();
+        }
+        ::close(m_read);
+    }
+
+    int fd() const {
+        return m_write;
+    }
+
+    // Close the write end and return everything read
+    const std::string& finish() {
+        ::close(m_write);
+        m_thread.join();
+        return m_text;
+    }
+
+private:
+    int m_read = -1;
+    int m_write = -1;
+    std::string m_text;
+    std::thread m_thread;
+};
+
+std::vector<std::string> split_lines(const std::string& text) {
+    std::vector<std::string> lines;
+    std::size_t pos = 0;
+    for (std::size_t end; (end = text.find('\n', pos)) != std::string::npos; pos = end + 1) {
+        lines.push_back(text.substr(pos, end - pos));
+    }
+    EXPECT_EQ(pos, text.size());  // Every line is newline-terminated
+    return lines;
+}
+
+// "HH:MM:SS.uuuuuu " prefix; returns the rest of the line
+std::string strip_stamp(const std::string& line) {
+    const char* pattern = "00:00:00.000000 ";
+    EXPECT_GE(line.size(), 16u);
+    for (std::size_t i = 0; i < 16 && i < line.size(); ++i) {
+        if (pattern[i] == '0') {
+            EXPECT_TRUE(std::isdigit(static_cast<unsigned char>(line[i]))) << line;
+        } else {
+            EXPECT_EQ(line[i], pattern[i]) << line;
+        }
+    }
+    return line.size() < 16 ? std::string() : line.substr(16);
+}
+
+} // namespace
+
+TEST(AsyncLoggerTest, FormatsStampsAndTerminatesLines) {
+    pipe_reader reader;
+    {
+        async_logger<32, 16> log(reader.fd());
+        log.log() << "order " << 42 << " filled";
+        log.log() << "a line much longer than thirty-one characters";
+        auto line = log.log();
+        ASSERT_TRUE(line);
+        line.text()->append_hex(255u, 4);
+        log.flush();
+        EXPECT_EQ(log.dropped(), 0u);
+        EXPECT_EQ(log.write_errors(), 0u);
+    }
+    std::vector<std::string> lines = split_lines(reader.finish());
+    ASSERT_EQ(lines.size(), 3u);
+    EXPECT_EQ(strip_stamp(lines[0]), "order 42 filled");
+    EXPECT_EQ(strip_stamp(lines[1]), "a line much longer than thirty");  // 31 with the newline
+    EXPECT_EQ(strip_stamp(lines[2]), "00ff");
+}
+
+TEST(AsyncLoggerTest, BlockingKeepsEveryLineInThreadOrder) {
+    constexpr int threads = 4;
+    constexpr int per_thread = 5000;
+    pipe_reader reader;
+    {
+        async_logger<64, 16> log(reader.fd(), log_overflow::block);
+        std::vector<std::thread> producers;
+        for (int t = 0; t < threads; ++t) {
+            producers.emplace_back([&log, t] {
+                for (int i = 0; i < per_thread; ++i) {
+                    log.log() << t << ',' << i;
+                }
+            });
+        }
+        for (auto& p : producers) {
+            p.join();
+        }
+        EXPECT_EQ(log.dropped(), 0u);
+    }
+    std::vector<std::string> lines = split_lines(reader.finish());
+    ASSERT_EQ(lines.size(), static_cast<std::size_t>(threads * per_thread));
+    int next[threads] = {};
+    for (const std::string& line : lines) {
+        auto fields = split_parse<int, 2>(strip_stamp(line), ',');
+        ASSERT_TRUE(fields) << line;
+        int t = (*fields)[0];
+        ASSERT_EQ((*fields)[1], next[t]);
+        ++next[t];
+    }
+}
+
+TEST(AsyncLoggerTest, FloodingThreadDoesNotStarveOthers) {
+    int fds[2];
+    ASSERT_EQ(::pipe(fds), 0);
+    // Fill the pipe so the background thread blocks in its first writev()
+    int flags = ::fcntl(fds[1], F_GETFL);
+    ::fcntl(fds[1], F_SETFL, flags | O_NONBLOCK);
+    char filler[4096] = {};
+    std::size_t prefilled = 0;
+    for (ssize_t n; (n = ::write(fds[1], filler, sizeof(filler))) > 0;) {
+        prefilled += static_cast<std::size_t>(n);
+    }
+    ::fcntl(fds[1], F_SETFL, flags);
+
+    constexpr int slow_lines = 5;
+    std::string text;
+    {
+        async_logger<32, 256> log(fds[1]);
+        // This thread registers first and fills its queue, many batches deep
+        log.log() << "flood";
+        for (int i = 0; i < 300; ++i) {
+            log.log() << "flood";
+        }
+        std::thread([&log] {
+            for (int i = 0; i < slow_lines; ++i) {
+                log.log() << "slow " << i;
+            }
+        }).join();
+
+        std::thread drain([&] {
+            char buf[4096];
+            std::size_t skipped = 0;
+            ssize_t n;
+            while ((n = ::read(fds[0], buf, sizeof(buf))) > 0) {
+                std::size_t got = static_cast<std::size_t>(n);
+                std::size_t skip = std::min(got, prefilled - skipped);
+                skipped += skip;
+                text.append(buf + skip, got - skip);
+            }
+        });
+        log.flush();
+        ::close(fds[1]);
+        drain.join();
+    }
+    ::close(fds[0]);
+
+    // The slow thread's lines go out in the first batch that starts at it,
+    // not after everything already queued by the flooding one
+    std::vector<std::string> lines = split_lines(text);
+    std::size_t first_slow = lines.size();
+    int next = 0;
+    for (std::size_t i = 0; i < lines.size(); ++i) {
+        std::string line = strip_stamp(lines[i]);
+        if (line != "flood") {
+            ASSERT_EQ(line, "slow " + std::to_string(next));
+            first_slow = std::min(first_slow, i);
+            ++next;
+        }
+    }
+    EXPECT_EQ(next, slow_lines);
+    constexpr std::size_t batch = async_logger<32, 256>::batch_lines;
+    EXPECT_LE(first_slow, 1 + 2 * batch);
+    EXPECT_GT(lines.size() - static_cast<std::size_t>(slow_lines), first_slow + batch);
+}
+
+TEST(AsyncLoggerTest, DropsWhenTheQueueIsFull) {
+    int fds[2];
+    ASSERT_EQ(::pipe(fds), 0);
+    // Fill the pipe so the background thread blocks in its first writev()
+    int flags = ::fcntl(fds[1], F_GETFL);
+    ::fcntl(fds[1], F_SETFL, flags | O_NONBLOCK);
+    char filler[4096] = {};
+    std::size_t prefilled = 0;
+    for (ssize_t n; (n = ::write(fds[1], filler, sizeof(filler))) > 0;) {
+        prefilled += static_cast<std::size_t>(n);
+    }
+    ::fcntl(fds[1], F_SETFL, flags);
+
+    constexpr int attempts = 100;
+    std::size_t dropped;
+    std::string text;
+    {
+        async_logger<32, 8> log(fds[1]);
+        for (int i = 0; i < attempts; ++i) {
+            log.log() << "line " << i;
+        }
+        dropped = log.dropped();
+        EXPECT_GE(dropped, static_cast<std::size_t>(attempts - 8));
+
+        std::thread drain([&] {
+            char buf[4096];
+            std::size_t skipped = 0;
+            ssize_t n;
+            while ((n = ::read(fds[0], buf, sizeof(buf))) > 0) {
+                std::size_t got = static_cast<std::size_t>(n);
+                std::size_t skip = std::min(got, prefilled - skipped);
+                skipped += skip;
+                text.append(buf + skip, got - skip);
+            }
+        });
+        log.flush();
+        ::close(fds[1]);
+        drain.join();
+    }
+    ::close(fds[0]);
+    EXPECT_EQ(split_lines(text).size() + dropped, static_cast<std::size_t>(attempts));
+}
@@ -0,0 +1,146 @@
+#include <gtest/gtest.h>
+#include <stack_string_mapped.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace stack_string;
+
+namespace {
+
+std::string temp_file(const char* name) {
+    std::string path = ::testing::TempDir() + name;
+    std::remove(path.c_str());
+    return path;
+}
+
+std::vector<char> read_file(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::vector<char>(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+void write_file(const std::string& path, const std::vector<char>& bytes) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+}
+
+} // namespace
+
+TEST(MappedArrayTest, RoundTrip) {
+    std::string path = temp_file("mapped_round_trip.ssa");
+    std::vector<std::string> texts;
+    for (int i = 0; i < 3000; ++i) {  // More than one checksum block
+        texts.push_back("instrument-" + std::to_string(i));
+    }
+    texts.push_back("");
+    texts.push_back("this text is longer than the capacity");
+
+    mapped_array_writer<StackString<32>> out;
+    ASSERT_EQ(out.open(path.c_str()), std::errc());
+    for (const std::string& t : texts) {
+        out.push_back(t);
+    }
+    out.push_back(StackString<8>("short"));
+    ASSERT_EQ(out.commit(), std::errc());
+
+    mapped_array<StackString<32>> in;
+    ASSERT_EQ(in.open(path.c_str()), std::errc());
+    ASSERT_EQ(in.size(), texts.size() + 1);
+    EXPECT_EQ(in.header().capacity, 32u);
+    EXPECT_EQ(in.header().element_size, sizeof(StackString<32>));
+    for (std::size_t i = 0; i + 1 < texts.size(); ++i) {
+        EXPECT_EQ(in[i], texts[i]);
+    }
+    EXPECT_EQ(in[texts.size() - 1], "this text is longer than the ca");  // Truncated to 31
+    EXPECT_EQ(in[texts.size()], "short");
+    EXPECT_EQ(in.end() - in.begin(), static_cast<std::ptrdiff_t>(in.size()));
+
+    // Same contents, same bytes
+    std::vector<char> first = read_file(path);
+    mapped_array_writer<StackString<32>> again;
+    ASSERT_EQ(again.open(path.c_str()), std::errc());
+    for (const StackString<32>& s : in) {
+        again.push_back(s);
+    }
+    ASSERT_EQ(again.commit(), std::errc());
+    EXPECT_EQ(read_file(path), first);
+
+    mapped_array<StackString<32>> moved(std::move(in));
+    EXPECT_FALSE(in.is_open());
+    EXPECT_EQ(moved[0], "instrument-0");
+}
+
+TEST(MappedArrayTest, RejectsOtherLayouts) {
+    std::string path = temp_file("mapped_layout.ssa");
+    mapped_array_writer<StackString<16>> out;
+    ASSERT_EQ(out.open(path.c_str()), std::errc());
+    out.push_back("AAPL");
+    ASSERT_EQ(out.commit(), std::errc());
+
+    mapped_array<StackString<24>> wrong_capacity;
+    EXPECT_EQ(wrong_capacity.open(path.c_str()), std::errc::invalid_argument);
+    EXPECT_FALSE(wrong_capacity.is_open());
+    mapped_array<StackString<16, Options::Compact>> wrong_options;
+    EXPECT_EQ(wrong_options.open(path.c_str()), std::errc::invalid_argument);
+
+    mapped_array<StackString<16>> missing;
+    EXPECT_EQ(missing.open((path + ".missing").c_str()), std::errc::no_such_file_or_directory);
+    EXPECT_TRUE(missing.empty());
+}
+
+TEST(MappedArrayTest, DetectsDamage) {
+    std::string path = temp_file("mapped_damage.ssa");
+    mapped_array_writer<StackString<16>> out;
+    ASSERT_EQ(out.open(path.c_str()), std::errc());
+    out.push_back("AAPL");
+    out.push_back("MSFT");
+    ASSERT_EQ(out.commit(), std::errc());
+    std::vector<char> bytes = read_file(path);
+
+    std::vector<char> corrupt = bytes;
+    corrupt[sizeof(mapped_array_header) + 1] ^= 0x20;
+    write_file(path, corrupt);
+    mapped_array<StackString<16>> in;
+    EXPECT_EQ(in.open(path.c_str()), std::errc::bad_message);
+    // Header checks alone do not read the elements
+    ASSERT_EQ(in.open(path.c_str(), mapped_check::header), std::errc());
+    EXPECT_EQ(in[0], "AaPL");
+
+    std::vector<char> truncated(bytes.begin(), bytes.end() - 1);
+    write_file(path, truncated);
+    EXPECT_EQ(in.open(path.c_str(), mapped_check::header), std::errc::bad_message);
+
+    std::vector<char> foreign = bytes;
+    foreign[0] = 'X';
+    write_file(path, foreign);
+    EXPECT_EQ(in.open(path.c_str()), std::errc::invalid_argument);
+}
+
+TEST(MappedArrayTest, CompactAndAbandonedWriter) {
+    std::string path = temp_file("mapped_compact.ssa");
+    {
+        mapped_array_writer<StackString<16, Options::Compact>> out;
+        ASSERT_EQ(out.open(path.c_str()), std::errc());
+        out.push_back("fifteen chars!!");
+        out.push_back("x");
+        EXPECT_EQ(out.size(), 2u);
+        ASSERT_EQ(out.commit(), std::errc());
+    }
+    {
+        // Never committed: the previous file stays
+        mapped_array_writer<StackString<16, Options::Compact>> out;
+        ASSERT_EQ(out.open(path.c_str()), std::errc());
+        out.push_back("lost");
+    }
+    std::ifstream temp(path + ".tmp");
+    EXPECT_FALSE(temp.good());
+
+    mapped_array<StackString<16, Options::Compact>> in;
+    ASSERT_EQ(in.open(path.c_str()), std::errc());
+    ASSERT_EQ(in.size(), 2u);
+    EXPECT_EQ(in[0], "fifteen chars!!");
+    EXPECT_EQ(in[1], "x");
+    EXPECT_EQ(in.header().options, static_cast<std::uint32_t>(Options::Compact));
+}
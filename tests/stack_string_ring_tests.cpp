@@ -0,0 +1,106 @@
+#include <gtest/gtest.h>
+#include <stack_string_ring.hpp>
+
+#include <thread>
+#include <vector>
+
+using namespace stack_string;
+
+TEST(RingTest, ReserveCommitAndWrap) {
+    ring<StackString<32>, 4> q;
+    EXPECT_TRUE(q.empty());
+    EXPECT_EQ(q.front(), nullptr);
+
+    for (int round = 0; round < 3; ++round) {
+        for (int i = 0; i < 4; ++i) {
+            auto r = q.reserve();
+            ASSERT_TRUE(r);
+            EXPECT_TRUE(r->empty());  // Reused slots come back cleared
+            *r << "line " << round * 4 + i;
+            q.commit(r);
+            EXPECT_FALSE(r);
+        }
+        EXPECT_FALSE(q.reserve());
+        EXPECT_EQ(q.size(), 4u);
+        for (int i = 0; i < 4; ++i) {
+            StackString<32> expected;
+            expected << "line " << round * 4 + i;
+            ASSERT_NE(q.front(), nullptr);
+            EXPECT_EQ(*q.front(), expected);
+            q.pop();
+        }
+        EXPECT_TRUE(q.empty());
+    }
+
+    EXPECT_TRUE(q.push(StackString<32>("copied")));
+    StackString<32> out;
+    EXPECT_TRUE(q.pop(out));
+    EXPECT_EQ(out, "copied");
+    EXPECT_FALSE(q.pop(out));
+}
+
+TEST(RingTest, SingleProducerThread) {
+    constexpr int count = 100000;
+    ring<StackString<24>, 256> q;
+    std::thread producer([&] {
+        for (int i = 0; i < count;) {
+            if (auto r = q.reserve()) {
+                r->append(i);
+                q.commit(r);
+                ++i;
+            } else {
+                std::this_thread::yield();  // Full: let the consumer run
+            }
+        }
+    });
+    for (int expected = 0; expected < count;) {
+        if (StackString<24>* line = q.front()) {
+            ASSERT_EQ(line->to<int>(), expected);
+            q.pop();
+            ++expected;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+    EXPECT_TRUE(q.empty());
+}
+
+TEST(RingTest, MultipleProducersKeepPerThreadOrder) {
+    constexpr int producers = 4;
+    constexpr int per_producer = 20000;
+    ring<StackString<24>, 64, ring_mode::mpsc> q;
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&q, p] {
+            for (int i = 0; i < per_producer;) {
+                if (auto r = q.reserve()) {
+                    *r << p << ':' << i;
+                    q.commit(r);
+                    ++i;
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    int next[producers] = {};
+    for (int received = 0; received < producers * per_producer;) {
+        StackString<24>* line = q.front();
+        if (!line) {
+            std::this_thread::yield();
+            continue;
+        }
+        auto fields = split_parse<int, 2>(*line, ':');
+        ASSERT_TRUE(fields);
+        int p = (*fields)[0];
+        ASSERT_EQ((*fields)[1], next[p]);
+        ++next[p];
+        q.pop();
+        ++received;
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    EXPECT_TRUE(q.empty());
+}
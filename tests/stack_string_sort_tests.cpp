@@ -0,0 +1,90 @@
+#include <gtest/gtest.h>
+#include <stack_string_sort.hpp>
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+using namespace stack_string;
+
+namespace {
+
+template <typename S>
+std::vector<S> random_strings(std::size_t count, std::size_t max_len, char lo, char hi, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<std::size_t> len(0, max_len);
+    std::uniform_int_distribution<int> byte(lo, hi);
+    std::vector<S> out;
+    for (std::size_t i = 0; i < count; ++i) {
+        S s;
+        for (std::size_t n = len(rng); n > 0; --n) {
+            s.append(static_cast<char>(byte(rng)));
+        }
+        out.push_back(s);
+    }
+    return out;
+}
+
+template <typename S>
+void expect_sorts_like_std(std::vector<S> values) {
+    std::vector<S> expected = values;
+    std::sort(expected.begin(), expected.end());
+    radix_sort(values.begin(), values.end());
+    EXPECT_EQ(values, expected);
+}
+
+} // namespace
+
+TEST(RadixSortTest, MatchesStdSort) {
+    expect_sorts_like_std(random_strings<StackString<16>>(5000, 15, 'A', 'Z', 1));
+    // Few distinct bytes: deep buckets and many duplicates
+    expect_sorts_like_std(random_strings<StackString<16>>(5000, 15, 'a', 'c', 2));
+    // Bytes above 0x7f order after ASCII
+    expect_sorts_like_std(random_strings<StackString<8>>(3000, 7, -128, 127, 3));
+    expect_sorts_like_std(random_strings<StackString<32, Options::Compact>>(3000, 31, '0', '9', 4));
+    // Swapped as whole objects; the other layouts go through std::swap
+    static_assert(std::is_trivially_copyable_v<StackString<16, Options::TriviallyCopyable>>);
+    expect_sorts_like_std(random_strings<StackString<16, Options::TriviallyCopyable>>(5000, 15, 'a', 'd', 5));
+}
+
+TEST(RadixSortTest, SharedPrefixesAndSmallRanges) {
+    // All equal up to max_size(): every level up to the last has one bucket
+    std::vector<StackString<12>> same(200, StackString<12>("SYMBOL.XNAS"));
+    same[100] = "SYMBOL.XNAR";
+    same[7] = "";
+    radix_sort(same.begin(), same.end());
+    EXPECT_EQ(same[0], "");
+    EXPECT_EQ(same[1], "SYMBOL.XNAR");
+    EXPECT_EQ(same[199], "SYMBOL.XNAS");
+
+    // Strings filled to all N characters by resize() differ in byte N - 1
+    std::vector<StackString<4>> full;
+    for (int i = 0; i < 40; ++i) {
+        StackString<4> s("abc");
+        s.resize(4, static_cast<char>('z' - i % 26));
+        full.push_back(s);
+    }
+    expect_sorts_like_std(full);
+
+    std::vector<StackString<16>> prefixes;
+    std::string text;
+    for (int i = 0; i < 15; ++i) {
+        text.push_back(static_cast<char>('z' - i));
+        prefixes.emplace_back(std::string_view(text));
+        prefixes.emplace_back(std::string_view(text));
+    }
+    std::reverse(prefixes.begin(), prefixes.end());
+    expect_sorts_like_std(prefixes);
+
+    std::vector<StackString<8>> few = {"b", "a"};
+    radix_sort(few.begin(), few.end());
+    EXPECT_EQ(few[0], "a");
+    radix_sort(few.begin(), few.begin());
+
+    StackString<8> array[] = {"delta", "alpha", "charlie", "bravo"};
+    radix_sort(std::begin(array), std::end(array));
+    EXPECT_EQ(array[0], "alpha");
+    EXPECT_EQ(array[3], "delta");
+}
@@ -0,0 +1,107 @@
+#include <gtest/gtest.h>
+#include <stack_string.hpp>
+
+#include <cstdio>
+#include <string>
+#include <thread>
+
+using namespace stack_string;
+
+// Built a second time with STACK_STRING_STATS (see CMakeLists.txt). Types
+// used only here keep other tests' writes out of the counts.
+
+TEST(StringStatsTest, CountsWritesPerType) {
+    using Line = StackString<41>;
+    string_stats before = string_stats_of<Line>().stats();
+    Line s("0123456789");             // A write of 10: bucket 10 * 8 / 41 = 1
+    s.append(std::string(31, 'x'));  // A write of 40 that dropped one character
+    s.clear();                       // Empty: not sampled
+    string_stats after = string_stats_of<Line>().stats();
+
+    if (!string_stats_enabled) {
+        EXPECT_EQ(after.writes, 0u);
+        EXPECT_EQ(after.truncations, 0u);
+        return;
+    }
+    EXPECT_EQ(after.writes - before.writes, 2u);
+    EXPECT_EQ(after.truncations - before.truncations, 1u);
+    EXPECT_EQ(after.peak_size, 40u);
+    EXPECT_EQ(after.histogram[1] - before.histogram[1], 1u);
+    EXPECT_EQ(after.histogram[7] - before.histogram[7], 1u);
+    EXPECT_EQ(string_stats_of<Line>().capacity(), 41u);
+
+    // Each Options combination is its own type
+    using CompactLine = StackString<41, Options::Compact>;
+    CompactLine compact("abc");
+    EXPECT_EQ(string_stats_of<Line>().stats().writes, after.writes);
+    EXPECT_EQ(string_stats_of<CompactLine>().options(), static_cast<unsigned>(Options::Compact));
+    EXPECT_EQ(string_stats_of<CompactLine>().stats().peak_size, 3u);
+}
+
+TEST(StringStatsTest, FullStringCountsInLastBucket) {
+    // Registered back to back, so their slots are adjacent
+    const string_stats_site& full = string_stats_of<StackString<43>>();
+    const string_stats_site& next = string_stats_of<StackString<44>>();
+    StackString<43> s;
+    s.resize(43);  // resize() fills all N characters
+    ASSERT_EQ(s.size(), 43u);
+
+    string_stats f = full.stats();
+    if (!string_stats_enabled) {
+        EXPECT_EQ(f.writes, 0u);
+        return;
+    }
+    EXPECT_EQ(f.writes, 1u);
+    EXPECT_EQ(f.peak_size, 43u);
+    EXPECT_EQ(f.histogram[string_stats_buckets - 1], 1u);
+    string_stats n = next.stats();
+    EXPECT_EQ(n.writes, 0u);
+    EXPECT_EQ(n.truncations, 0u);
+    EXPECT_EQ(n.peak_size, 0u);
+}
+
+TEST(StringStatsTest, TagsAcrossThreads) {
+    string_stats_tag& tag = STACK_STRING_STATS_TAG("stats_tag_test");
+    auto work = [&tag] {
+        string_stats_scope scope(tag);
+        StackString<8> s("abcdefghij");  // Truncated to 7
+        s.resize(2);
+    };
+    std::thread(work).join();
+    std::thread(work).join();  // May take over the first thread's block
+    work();
+    StackString<42> untagged("outside any scope");
+
+    string_stats s = tag.stats();
+    if (!string_stats_enabled) {
+        EXPECT_EQ(s.writes, 0u);
+        return;
+    }
+    EXPECT_EQ(s.writes, 6u);
+    EXPECT_EQ(s.truncations, 3u);
+    EXPECT_EQ(s.peak_size, 7u);
+    EXPECT_EQ(s.histogram[7], 3u);
+    EXPECT_EQ(s.histogram[2], 3u);
+    EXPECT_EQ(tag.capacity(), 0u);
+    EXPECT_EQ(string_stats_of<StackString<42>>().stats().writes, 1u);
+
+    bool found = false;
+    for_each_string_stats([&](const string_stats_site& site) {
+        found = found || &site == &tag;
+    });
+    EXPECT_TRUE(found);
+
+    std::FILE* out = std::tmpfile();
+    ASSERT_NE(out, nullptr);
+    dump_string_stats(out);
+    std::rewind(out);
+    std::string text;
+    char chunk[256];
+    while (std::fgets(chunk, sizeof(chunk), out)) {
+        text += chunk;
+    }
+    std::fclose(out);
+    EXPECT_NE(text.find("StackString<42, options=0>: writes=1 truncations=0 peak=17 histogram=0,0,0,1,0,0,0,0"),
+              std::string::npos);
+    EXPECT_NE(text.find("stats_tag_test ("), std::string::npos);
+}
@@ -1,6 +1,13 @@
 #include <gtest/gtest.h>
 #include <stack_string.hpp>
 
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <map>
+#include <type_traits>
+#include <utility>
+
 using namespace stack_string;
 
 TEST(StackStringTest, BasicAppendAndSize) {
@@ -38,3 +45,514 @@ TEST(StackStringTest, ImplicitConversion) {
     const char* cstr = s;
     EXPECT_STREQ(cstr, "abc");
 }
+
+TEST(StackStringTest, SizeTypeMatchesCapacity) {
+    static_assert(sizeof(StackString<15>) == 17);
+    static_assert(sizeof(StackString<255>) == 257);
+    static_assert(sizeof(StackString<300>) == 304);
+    StackString<300> s;
+    s.resize(300, 'a');
+    EXPECT_EQ(s.size(), 300u);
+}
+
+TEST(StackStringTest, CompactLayout) {
+    static_assert(sizeof(StackString<15, Options::Compact>) == 16);
+    StackString<15, Options::Compact> s("AAPL");
+    EXPECT_EQ(s.size(), 4u);
+    EXPECT_STREQ(s.c_str(), "AAPL");
+    s << "." << 42;
+    EXPECT_EQ(s, "AAPL.42");
+    StackString<15, Options::Compact> copy(s);
+    EXPECT_EQ(copy, "AAPL.42");
+    s.resize(15, 'x');
+    EXPECT_EQ(s.size(), 15u);
+    EXPECT_EQ(s.c_str()[15], '\0');
+    s.clear();
+    EXPECT_TRUE(s.empty());
+}
+
+TEST(StackStringTest, MoveLeavesSourceIntact) {
+    StackString<32> a("payload");
+    StackString<32> b(std::move(a));
+    EXPECT_EQ(b, "payload");
+    EXPECT_EQ(a, "payload");
+    StackString<32> c;
+    c = std::move(b);
+    EXPECT_EQ(c, "payload");
+    EXPECT_EQ(b, "payload");
+}
+
+TEST(StackStringTest, TriviallyCopyableOption) {
+    using Trivial = StackString<16, Options::TriviallyCopyable>;
+    static_assert(std::is_trivially_copyable_v<Trivial>);
+    static_assert(std::is_trivially_copyable_v<StackString<15, Options::Compact | Options::TriviallyCopyable>>);
+    static_assert(!std::is_trivially_copyable_v<StackString<16>>);
+
+    Trivial src("ring");
+    alignas(Trivial) unsigned char raw[sizeof(Trivial)];
+    std::memcpy(raw, &src, sizeof(Trivial));
+    Trivial dst;
+    std::memcpy(&dst, raw, sizeof(Trivial));
+    EXPECT_EQ(dst, "ring");
+    EXPECT_EQ(dst.size(), 4u);
+}
+
+TEST(StackStringTest, FloatingPointAppend) {
+    StackString<64> s;
+    s << "px=" << 101.25 << " q=" << 0.5f;
+    EXPECT_EQ(s, "px=101.25 q=0.5");
+
+    StackString<64> f;
+    f.append(3.14159, std::chars_format::fixed, 2);
+    f << ' ' << scientific(1234.5, 1) << ' ' << fixed(2.0, 3);
+    EXPECT_EQ(f, "3.14 1.2e+03 2.000");
+
+    StackString<32> v("lat=", 12.5, "us");
+    EXPECT_EQ(v, "lat=12.5us");
+}
+
+TEST(StackStringTest, FloatingPointDoesNotFit) {
+    StackString<8> s("ab");
+    s.append(3.14159265358979);
+    EXPECT_EQ(s, "ab");
+}
+
+TEST(StackStringTest, LiteralAndArrayAppend) {
+    StackString<16> s("lit");
+    s << "eral" << '!';
+    EXPECT_EQ(s, "literal!");
+
+    char buf[16] = "abc";
+    s.append(buf);
+    EXPECT_EQ(s, "literal!abc");
+
+    char unterminated[4] = {'w', 'x', 'y', 'z'};
+    StackString<16> u;
+    u.append(unterminated);
+    EXPECT_EQ(u, "wxyz");
+
+    const char* ptr = "ptr";
+    u += ptr;
+    EXPECT_EQ(u, "wxyzptr");
+
+    StackString<4> tiny("truncated");
+    EXPECT_EQ(tiny, "tru");
+}
+
+TEST(StackStringTest, SwapExchangesWholeBuffers) {
+    StackString<8> a("abc");
+    StackString<8> b("wxyzuv");
+    swap(a, b);
+    EXPECT_EQ(a, "wxyzuv");
+    EXPECT_EQ(b, "abc");
+
+    StackString<8, Options::Compact | Options::TrackTruncation> c("1234567890");
+    StackString<8, Options::Compact | Options::TrackTruncation> d;
+    c.swap(d);
+    EXPECT_TRUE(c.empty());
+    EXPECT_FALSE(c.truncated());
+    EXPECT_EQ(d, "1234567");
+    EXPECT_TRUE(d.truncated());
+}
+
+TEST(StackStringTest, ConstructFromUnterminatedArray) {
+    // N characters with no terminator: one more than fits
+    char full[8] = {'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h'};
+    StackString<8> s(full);
+    EXPECT_EQ(s, "abcdefg");
+    EXPECT_EQ(s.size(), s.max_size());
+    EXPECT_EQ(s.available(), 0u);
+    s.append("xyz");
+    EXPECT_EQ(s, "abcdefg");
+
+    char fits[7] = {'a', 'b', 'c', 'd', 'e', 'f', 'g'};
+    StackString<8> t(fits);
+    EXPECT_EQ(t, "abcdefg");
+    EXPECT_EQ(t.size(), 7u);
+}
+
+TEST(StackStringTest, AppendAcrossCapacities) {
+    StackString<8> small("abc");
+    StackString<32> big("x=");
+    big << small << ';';
+    big += small;
+    EXPECT_EQ(big, "x=abc;abc");
+
+    StackString<64> wide(big);
+    EXPECT_EQ(wide, "x=abc;abc");
+    StackString<4> narrow(big);
+    EXPECT_EQ(narrow, "x=a");
+}
+
+TEST(StackStringTest, CompareAcrossCapacities) {
+    StackString<16> small("AAPL");
+    StackString<32> big("AAPL");
+    StackString<32, Options::Compact> compact("AAPL");
+    EXPECT_TRUE(small == big);
+    EXPECT_TRUE(big == compact);
+    EXPECT_FALSE(small != compact);
+    big.append(".O");
+    EXPECT_TRUE(small != big);
+    EXPECT_TRUE(small < big);  // A prefix orders first
+    EXPECT_TRUE(big > small);
+    EXPECT_TRUE(small <= compact && small >= compact);
+
+    // Bytes order as unsigned char, like std::string_view
+    StackString<8> high("\xe9");
+    EXPECT_TRUE(small < high);
+    EXPECT_EQ(std::string_view(small) < std::string_view(high), small < high);
+
+    // Text on either side
+    EXPECT_TRUE("AAPL" == small);
+    EXPECT_TRUE("MSFT" != small);
+    EXPECT_TRUE(small < "MSFT");
+    EXPECT_TRUE("MSFT" > small);
+    EXPECT_TRUE(std::string("AAPL") <= small);
+    EXPECT_TRUE(small >= std::string_view("AAP"));
+    EXPECT_EQ(small.compare("AAPL"), 0);
+    EXPECT_LT(small.compare("AAPLE"), 0);
+    EXPECT_GT(small.compare("AAPK"), 0);
+
+    static_assert(StackString<8>("ab") < StackString<16>("b"), "usable in constant expressions");
+    static_assert(StackString<8>("ab") == StackString<16>("ab"), "usable in constant expressions");
+
+    std::map<StackString<16>, int> by_symbol;
+    by_symbol["MSFT"] = 2;
+    by_symbol["AAPL"] = 1;
+    by_symbol["IBM"] = 3;
+    EXPECT_EQ(by_symbol.begin()->first, "AAPL");
+    EXPECT_EQ(by_symbol.rbegin()->second, 2);
+}
+
+TEST(StackStringTest, SearchOperations) {
+    StackString<64> s("8=FIX.4.2|9=65|35=A|49=SERVER|56=CLIENT|");
+    EXPECT_EQ(s.find('|'), 9u);
+    EXPECT_EQ(s.find("35="), 15u);
+    EXPECT_EQ(s.rfind('|'), s.size() - 1);
+    EXPECT_EQ(s.rfind("=", 20), 17u);
+    EXPECT_EQ(s.find_first_of("=|"), 1u);
+    EXPECT_EQ(s.find_first_not_of("0123456789"), 1u);
+    EXPECT_EQ(s.find("missing"), StackString<64>::npos);
+    EXPECT_TRUE(s.starts_with("8=FIX"));
+    EXPECT_TRUE(s.ends_with("CLIENT|"));
+    EXPECT_TRUE(s.contains("SERVER"));
+    EXPECT_FALSE(s.contains('#'));
+}
+
+TEST(StackStringTest, SearchMatchesStringView) {
+    // Cover block boundaries, tails and every start position
+    StackString<100> s;
+    for (int i = 0; s.size() < 99; ++i) {
+        s << static_cast<char>('a' + (i * 7) % 5);
+    }
+    std::string_view sv = s;
+    const std::string_view needles[] = {"", "a", "ab", "cab", "eccb", "zz", "bdace", "dacebdaceb"};
+    for (std::size_t pos = 0; pos <= sv.size() + 1; ++pos) {
+        for (char c : std::string_view("abcez")) {
+            EXPECT_EQ(s.find(c, pos), sv.find(c, pos));
+            EXPECT_EQ(s.rfind(c, pos), sv.rfind(c, pos));
+            EXPECT_EQ(s.find_first_not_of(c, pos), sv.find_first_not_of(c, pos));
+        }
+        for (std::string_view n : needles) {
+            EXPECT_EQ(s.find(n, pos), sv.find(n, pos)) << n << " @" << pos;
+            EXPECT_EQ(s.rfind(n, pos), sv.rfind(n, pos)) << n << " @" << pos;
+            EXPECT_EQ(s.find_first_of(n, pos), sv.find_first_of(n, pos));
+            EXPECT_EQ(s.find_first_not_of(n, pos), sv.find_first_not_of(n, pos));
+        }
+        EXPECT_EQ(s.find_first_of("zyxwvutsrqa", pos), sv.find_first_of("zyxwvutsrqa", pos));
+    }
+}
+
+TEST(StackStringTest, ConstexprSearch) {
+    constexpr std::string_view text = "key=value";
+    static_assert(detail::find_char(text.data(), text.size(), text.size(), '=', 0) == 3);
+    static_assert(detail::find_substr(text.data(), text.size(), text.size(), "val", 0) == 4);
+    SUCCEED();
+}
+
+// C++17 leaves the bytes past the terminator uninitialized, which only GCC
+// accepts in a constant; C++20 zeroes them during constant evaluation
+#if STACK_STRING_CONSTEXPR_STORAGE || (defined(__GNUC__) && !defined(__clang__))
+constexpr StackString<48> fix_header() {
+    StackString<48> s("8=FIX.4.4");
+    const char* tag = "|35=";
+    s << '|' << "9=" << 178 << tag << 'D' << "|34=" << pad<6>(42u) << "|x=" << -17;
+    s.append(255, 16).append(5, 2).append_fill(2, '*');
+    return s;
+}
+
+TEST(StackStringTest, ConstexprBuilding) {
+    constexpr StackString<48> header = fix_header();
+    static_assert(header == "8=FIX.4.4|9=178|35=D|34=000042|x=-17ff101**");
+    constexpr StackString<16> joined = StackString<8>("GET") + ' ' + 404 + " OK";
+    static_assert(joined == "GET 404 OK");
+    constexpr StackString<8> cut = StackString<8>("abc") + ':' + 12345;
+    static_assert(cut == "abc:123");
+    constexpr StackString<16, Options::Compact> compact("compact");
+    static_assert(compact.size() == 7 && sizeof(compact) == 17);
+    constexpr StackString<4> no_room = [] {
+        StackString<4> s;
+        s << 1234;  // All or nothing, as at run time
+        return s;
+    }();
+    static_assert(no_room.empty());
+    constexpr StackString<16> copied = [] {
+        StackString<16> t;
+        t = StackString<16>(StackString<16, Options::Compact>("compact"));
+        t.resize(9, '!');
+        return t;
+    }();
+    static_assert(copied == "compact!!");
+    EXPECT_EQ(header, fix_header());
+}
+#endif
+
+TEST(StackStringTest, ConstexprIntegerMatchesToChars) {
+    const long long values[] = {0, 1, -1, 9, 10, 99, 100, -128, 65535, 1234567890123LL,
+                                std::numeric_limits<long long>::min(), std::numeric_limits<long long>::max()};
+    for (long long v : values) {
+        for (int base : {2, 8, 10, 16, 36}) {
+            char expected[72];
+            char actual[72];
+            auto [end, ec] = std::to_chars(expected, expected + sizeof(expected), v, base);
+            ASSERT_EQ(ec, std::errc());
+            char* actual_end = detail::integer_to_chars(actual, actual + sizeof(actual), v, base);
+            ASSERT_NE(actual_end, nullptr);
+            EXPECT_EQ(std::string_view(actual, actual_end - actual), std::string_view(expected, end - expected));
+            EXPECT_EQ(detail::integer_to_chars(actual, actual + (end - expected) - 1, v, base), nullptr);
+        }
+    }
+    char buf[24];
+    char* end = detail::integer_to_chars(buf, buf + sizeof(buf), std::numeric_limits<std::uint64_t>::max());
+    EXPECT_EQ(std::string_view(buf, end - buf), "18446744073709551615");
+}
+
+TEST(StackStringTest, HashDependsOnlyOnContents) {
+    // Dirty the buffer past size() so stale bytes would change a careless hash
+    StackString<32> a("abcdefghijklmnopqrstuvwxyz");
+    a.resize(5);
+    StackString<8> b("abcde");
+    StackString<15, Options::Compact> c("abcde");
+    EXPECT_EQ(hash(a), hash(std::string_view("abcde")));
+    EXPECT_EQ(hash(a), hash(b));
+    EXPECT_EQ(hash(a), hash(c));
+    EXPECT_EQ(std::hash<StackString<32>>{}(a), hash(a));
+    EXPECT_EQ(string_hash{}("abcde"), hash(a));
+
+    EXPECT_NE(hash(std::string_view("a")), hash(std::string_view("a\0", 2)));
+    EXPECT_NE(hash(a), hash(a, 1));
+    for (std::size_t len = 0; len < 31; ++len) {
+        StackString<32> x, y;
+        x.resize(len, 'q');
+        y.resize(len, 'q');
+        y.resize(len + 1, 'r');
+        EXPECT_NE(hash(x), hash(y));
+    }
+}
+
+TEST(StackStringTest, TruncationFlagIsSticky) {
+    StackString<8, Options::TrackTruncation> s;
+    s << "abc" << 42;
+    EXPECT_FALSE(s.truncated());
+    s << "defgh" << 'x';
+    EXPECT_EQ(s, "abc42de");
+    EXPECT_TRUE(s.truncated());
+    s.append_fill(1, '-');
+    EXPECT_TRUE(s.truncated());
+
+    auto copy = s;
+    EXPECT_TRUE(copy.truncated());
+    s.clear();
+    EXPECT_FALSE(s.truncated());
+    s << 123456789;  // to_chars result does not fit: nothing appended
+    EXPECT_TRUE(s.empty());
+    EXPECT_TRUE(s.truncated());
+
+    StackString<15, Options::Compact | Options::TrackTruncation> c("0123456789abcdefXYZ");
+    EXPECT_EQ(c.size(), 14u);
+    EXPECT_TRUE(c.truncated());
+}
+
+namespace {
+
+// Every length up to the capacity, so each kernel's block, word, overlap
+// and byte paths run; the Compact variant keeps its size in the last byte
+template <typename S>
+void check_transforms() {
+    for (std::size_t len = 0; len <= S().max_size(); ++len) {
+        std::string text;
+        for (std::size_t i = 0; i < len; ++i) {
+            text += static_cast<char>("Az@[`{aZ-q\xc3\x80\xe0\x7f "[(i * 7 + len) % 15]);
+        }
+        std::string lower = text;
+        std::string upper = text;
+        std::string replaced = text;
+        for (char& c : lower) c = (c >= 'A' && c <= 'Z') ? static_cast<char>(c + 32) : c;
+        for (char& c : upper) c = (c >= 'a' && c <= 'z') ? static_cast<char>(c - 32) : c;
+        for (char& c : replaced) c = (c == '@') ? '_' : c;
+
+        S s(text);
+        EXPECT_EQ(std::string_view(S(s).to_lower()), lower) << len;
+        EXPECT_EQ(std::string_view(S(s).to_upper()), upper) << len;
+        EXPECT_EQ(std::string_view(S(s).replace('@', '_')), replaced) << len;
+        EXPECT_EQ(S(s).to_lower().size(), len);
+        EXPECT_EQ(S(s).to_upper().c_str()[len], '\0');
+    }
+}
+
+} // namespace
+
+TEST(StackStringTest, CaseAndReplaceKernels) {
+    check_transforms<StackString<8>>();
+    check_transforms<StackString<40>>();
+    check_transforms<StackString<100>>();
+    check_transforms<StackString<100, Options::Compact>>();
+
+    StackString<16> s("Hello, World");
+    EXPECT_EQ(s.to_upper(), "HELLO, WORLD");
+    EXPECT_EQ(s.replace('O', '0').replace('x', 'x'), "HELL0, W0RLD");
+}
+
+TEST(StackStringTest, TrimEraseInsertSubstr) {
+    StackString<32> s(" \t 35=D |\r\n");
+    EXPECT_EQ(s.trim(), "35=D |");
+    EXPECT_EQ(s.rtrim("| "), "35=D");
+    EXPECT_EQ(StackString<8>("   ").trim(), "");
+    EXPECT_EQ(StackString<8>("xxabxx").ltrim("x"), "abxx");
+
+    StackString<16> e("0123456789");
+    EXPECT_EQ(e.erase(2, 3), "0156789");
+    EXPECT_EQ(e.erase(5), "01567");
+    EXPECT_EQ(e.erase(9, 1), "01567");
+    EXPECT_EQ(e.insert(1, "ab"), "0ab1567");
+    EXPECT_EQ(e.insert(99, 2, '!'), "0ab1567!!");
+    EXPECT_EQ(e.insert(0, 3, '-'), "---0ab1567!!");
+
+    // Overflow cuts from the end and is tracked
+    StackString<8, Options::TrackTruncation> t("abcdef");
+    t.insert(2, "XY");
+    EXPECT_EQ(t, "abXYcde");
+    EXPECT_TRUE(t.truncated());
+    t.clear();
+    t.insert(0, "0123456789");
+    EXPECT_EQ(t, "0123456");
+
+    StackString<32> line("8=FIX.4.4|35=D|");
+    EXPECT_EQ(line.substr(10), "35=D|");
+    EXPECT_EQ(line.substr(10, 4), "35=D");
+    StackString<4> tag = line.substr<4>(10);
+    EXPECT_EQ(tag, "35=");
+    EXPECT_TRUE(line.substr(line.size() + 1).empty());
+
+#if STACK_STRING_CONSTEXPR_STORAGE || (defined(__GNUC__) && !defined(__clang__))
+    constexpr StackString<32> folded = [] {
+        StackString<32> f("  Content-Type ");
+        f.trim().to_lower().replace('-', '_').insert(0, "h:");
+        f.erase(2, 1);
+        return f;
+    }();
+    static_assert(folded == "h:ontent_type");
+#endif
+}
+
+TEST(StackStringTest, TryAppendLeavesStringUnchanged) {
+    StackString<8, Options::TrackTruncation> s("abc");
+    EXPECT_TRUE(s.try_append("de"));
+    EXPECT_FALSE(s.try_append("fgh"));
+    EXPECT_FALSE(s.try_append(12345));
+    EXPECT_TRUE(s.try_append(12));
+    EXPECT_FALSE(s.try_append('x'));
+    EXPECT_EQ(s, "abcde12");
+    EXPECT_FALSE(s.truncated());
+
+    StackString<8> plain;
+    EXPECT_TRUE(plain.try_append(std::string_view("1234567")));
+    EXPECT_FALSE(plain.try_append(1.5));
+    EXPECT_EQ(plain, "1234567");
+}
+
+TEST(StackStringTest, ConcatenationExpression) {
+    StackString<16> user("alice");
+    std::string_view region = "eu";
+    StackString<64> key(user + ":" + region + ':' + 42 + ":" + std::string("x"));
+    EXPECT_EQ(key, "alice:eu:42:x");
+
+    key += user + "/" + -7;
+    EXPECT_EQ(key, "alice:eu:42:xalice/-7");
+
+    StackString<32> prefixed("id=" + user);
+    EXPECT_EQ(prefixed, "id=alice");
+
+    // One decision for the whole expression: the leading part is kept
+    StackString<8, Options::TrackTruncation> small(user + "-" + 123456);
+    EXPECT_EQ(small, "alice-1");
+    EXPECT_TRUE(small.truncated());
+
+    StackString<16> a("ab");
+    EXPECT_EQ(StackString<16>(a + a + a), "ababab");
+}
+
+TEST(StackStringTest, PaddedAndHexIntegers) {
+    StackString<64> s;
+    s.append_padded(7, 2).append(':').append_padded(5, 2) << '.' << pad<6>(42);
+    EXPECT_EQ(s, "07:05.000042");
+
+    s.clear();
+    s.append_padded(-42, 5) << '|';
+    s.append_padded(-42, 5, ' ') << '|' << pad(123456, 3) << '|' << pad<2>(-3);
+    EXPECT_EQ(s, "-0042|  -42|123456|-3");
+
+    s.clear();
+    s << hex(0xbeefu) << ' ' << hex(std::uint8_t(0x0a), 4, true) << ' ' << hex(-1) << ' ' << hex(0);
+    EXPECT_EQ(s, "beef 000A ffffffff 0");
+
+    s.clear();
+    s.append_padded(std::numeric_limits<std::int64_t>::min(), 0);
+    EXPECT_EQ(s, "-9223372036854775808");
+
+    StackString<6, Options::TrackTruncation> small("ab");
+    small << pad<4>(1);  // Needs 4 bytes, 3 left: nothing is written
+    EXPECT_EQ(small, "ab");
+    EXPECT_TRUE(small.truncated());
+    EXPECT_TRUE(small.try_append(hex(255u)));
+    EXPECT_FALSE(small.try_append(hex(255u)));
+    EXPECT_EQ(small, "abff");
+}
+
+TEST(StackStringTest, NumericParsing) {
+    EXPECT_EQ(StackString<32>("12345678901234567").to<std::uint64_t>(), 12345678901234567ULL);
+    EXPECT_EQ(StackString<32>("-2147483648").to<int>(), std::numeric_limits<int>::min());
+    EXPECT_EQ(StackString<32>("ff").parse<int>(16).value, 255);
+    EXPECT_EQ(StackString<32>("2.5").to<double>(), 2.5);
+
+    EXPECT_EQ(StackString<32>("12a45678").parse<int>().ec, std::errc::invalid_argument);
+    EXPECT_EQ(StackString<32>("42 ").parse<int>().ec, std::errc::invalid_argument);
+    EXPECT_EQ(StackString<32>("").parse<int>().ec, std::errc::invalid_argument);
+    EXPECT_EQ(StackString<32>("-1").parse<unsigned>().ec, std::errc::invalid_argument);
+    EXPECT_EQ(StackString<32>("256").parse<std::uint8_t>().ec, std::errc::result_out_of_range);
+    EXPECT_EQ(StackString<32>("99999999999999999999").parse<std::uint64_t>().ec,
+              std::errc::result_out_of_range);
+    EXPECT_FALSE(StackString<32>("1e").to<double>());
+
+    // Every length around the 8-digit chunks agrees with from_chars
+    StackString<32> digits;
+    for (int len = 1; len <= 19; ++len) {
+        digits.append(static_cast<char>('0' + len % 10));
+        std::uint64_t expected = 0;
+        std::from_chars(digits.data(), digits.data() + digits.size(), expected);
+        EXPECT_EQ(digits.to<std::uint64_t>(), expected) << digits.c_str();
+    }
+
+    int fields[4];
+    auto r = split_parse<int>("10,-20,30", ',', fields, 4);
+    EXPECT_TRUE(r);
+    EXPECT_EQ(r.value, 3u);
+    EXPECT_EQ(fields[1], -20);
+    EXPECT_EQ(split_parse<int>("1,x,3", ',', fields, 4).value, 1u);
+    EXPECT_EQ(split_parse<int>("1,2,3", ',', fields, 2).ec, std::errc::invalid_argument);
+
+    auto triple = split_parse<double, 3>("1.5|2|-3", '|');
+    ASSERT_TRUE(triple);
+    EXPECT_EQ((*triple)[2], -3.0);
+    EXPECT_FALSE((split_parse<int, 3>("1|2", '|')));
+}
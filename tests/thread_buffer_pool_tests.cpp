@@ -0,0 +1,71 @@
+#include <gtest/gtest.h>
+#include <thread_buffer_pool.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace stack_string;
+
+TEST(ThreadBufferPoolTest, SizeClassesAndLocalReuse) {
+    pooled_buffer small = thread_buffer_pool::acquire(100);
+    pooled_buffer medium = thread_buffer_pool::acquire(257);
+    EXPECT_EQ(small.size(), thread_buffer_pool::small_size);
+    EXPECT_EQ(medium.size(), thread_buffer_pool::medium_size);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(small.data()) % 64, 0u);
+    EXPECT_FALSE(thread_buffer_pool::acquire(thread_buffer_pool::large_size + 1));
+
+    char* data = small.data();
+    std::size_t cached = thread_buffer_pool::cached(100);
+    small.reset();
+    EXPECT_EQ(thread_buffer_pool::cached(100), cached + 1);
+    EXPECT_EQ(thread_buffer_pool::acquire(200).data(), data);
+}
+
+TEST(ThreadBufferPoolTest, BackedStringOutlivesFrame) {
+    using BufferString = std::basic_string<char, std::char_traits<char>, FixedBufAllocator<char>>;
+    struct Message {
+        pooled_buffer buffer = thread_buffer_pool::acquire(1024);
+        BufferString text{buffer.allocator()};
+    };
+    auto make = [] {
+        auto m = std::make_unique<Message>();
+        m->text.assign(600, 'x');
+        return m;
+    };
+    auto m = make();
+    EXPECT_EQ(m->text.size(), 600u);
+    EXPECT_GE(m->text.data(), m->buffer.data());
+    EXPECT_LT(m->text.data(), m->buffer.data() + m->buffer.size());
+}
+
+TEST(ThreadBufferPoolTest, CrossThreadReturnGoesToOwner) {
+    pooled_buffer block = thread_buffer_pool::acquire(4096);
+    char* data = block.data();
+    std::thread([b = std::move(block)]() mutable { b.reset(); }).join();
+    // The owner picks returned blocks up on its next checkout
+    EXPECT_EQ(thread_buffer_pool::acquire(4096).data(), data);
+
+    // Blocks released after their owner thread exited are freed, not
+    // cached by the releasing thread
+    std::size_t live = thread_buffer_pool::live_blocks();
+    std::size_t cached = thread_buffer_pool::cached(64);
+    std::vector<pooled_buffer> orphans;
+    std::thread([&orphans] {
+        for (int i = 0; i < 4; ++i) orphans.push_back(thread_buffer_pool::acquire(64));
+    }).join();
+    EXPECT_EQ(thread_buffer_pool::live_blocks(), live + 4);
+    orphans.clear();
+    EXPECT_EQ(thread_buffer_pool::live_blocks(), live);
+    EXPECT_EQ(thread_buffer_pool::cached(64), cached);
+
+    // A thread's cached blocks go back to the heap when it exits
+    std::thread([] {
+        pooled_buffer a = thread_buffer_pool::acquire(64);
+        pooled_buffer b = thread_buffer_pool::acquire(64);
+    }).join();
+    EXPECT_EQ(thread_buffer_pool::live_blocks(), live);
+}